@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "SPARQReflector.hpp"
+
+/**
+ * @brief Shape of a generated SPARQL result.
+ */
+struct SyntheticSpec {
+    size_t rows = 1000;
+    /// Characters per string value (an escape counts as one character).
+    size_t stringLength = 16;
+    /// Probability that a string character is written as an escape sequence.
+    double escapeDensity = 0.0;
+    /// Probability that a binding is left out of its row, as for an unbound OPTIONAL.
+    double missingRatio = 0.0;
+    uint64_t seed = 1;
+};
+
+/**
+ * @brief Deterministic generator of SPARQL JSON and TSV responses for benchmarks.
+ * Columns come from the members of T (strings, integers, floating point and bool), so the
+ * output always decodes into T. The same spec yields the same bytes on every platform:
+ * randomness comes from a fixed SplitMix64 stream instead of <random> distributions.
+ */
+class SyntheticSparql {
+public:
+    template <typename T>
+    static std::string json(const SyntheticSpec& spec) {
+        return generate<T>(spec, false);
+    }
+
+    template <typename T>
+    static std::string tsv(const SyntheticSpec& spec) {
+        return generate<T>(spec, true);
+    }
+
+private:
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : state(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        /// Uniform in [0, 1).
+        double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+        uint64_t below(uint64_t bound) { return next() % bound; }
+
+    private:
+        uint64_t state;
+    };
+
+    template <typename T>
+    static std::string generate(const SyntheticSpec& spec, bool tsv) {
+        using Dispatch = reflection_impl::MemberDispatch<T>;
+        Random random(spec.seed);
+        std::string out;
+        out.reserve(spec.rows * Dispatch::count * (spec.stringLength + (tsv ? 4 : 40)));
+
+        if (tsv) {
+            for (size_t i = 0; i < Dispatch::count; ++i) {
+                out += i ? "\t?" : "?";
+                out += Dispatch::names[i];
+            }
+            out += '\n';
+        } else {
+            out += R"({ "head": { "vars": [ )";
+            for (size_t i = 0; i < Dispatch::count; ++i) {
+                out += std::format(R"({}"{}")", i ? ", " : "", Dispatch::names[i]);
+            }
+            out += " ] }, \"results\": { \"bindings\": [\n";
+        }
+
+        for (size_t row = 0; row < spec.rows; ++row) {
+            if (!tsv) out += row ? ",\n{ " : "{ ";
+            bool firstBinding = true;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                (appendMember<T, I>(out, random, spec, tsv, firstBinding), ...);
+            }(std::make_index_sequence<Dispatch::count>{});
+            out += tsv ? "\n" : " }";
+        }
+
+        if (!tsv) out += "\n] } }\n";
+        return out;
+    }
+
+    template <typename T, size_t I>
+    static void appendMember(std::string& out, Random& random, const SyntheticSpec& spec, bool tsv, bool& firstBinding) {
+        using Dispatch = reflection_impl::MemberDispatch<T>;
+        using V = typename [: meta::type_of(Dispatch::members[I]) :];
+        static_assert(std::is_same_v<V, std::string> || std::is_arithmetic_v<V>,
+                      "SyntheticSparql generates string, bool and numeric columns only");
+
+        if (tsv && I > 0) out += '\t';
+        if (random.unit() < spec.missingRatio) return; // Unbound: empty TSV cell, absent JSON key
+
+        if (!tsv) {
+            out += std::format(R"({}"{}": {{ "type": "literal", )", firstBinding ? "" : ", ", Dispatch::names[I]);
+            firstBinding = false;
+        }
+
+        if constexpr (std::is_same_v<V, std::string>) {
+            if (!tsv) out += R"("value": )";
+            out += '"';
+            appendText(out, random, spec, tsv);
+            out += '"';
+            if (!tsv) out += " }";
+        } else {
+            std::string value;
+            std::string_view datatype;
+            if constexpr (std::is_same_v<V, bool>) {
+                value = random.below(2) ? "true" : "false";
+                datatype = "boolean";
+            } else if constexpr (std::is_integral_v<V>) {
+                value = std::format("{}", random.below(1000000));
+                datatype = "integer";
+            } else {
+                value = std::format("{:.3f}", random.unit() * 100000.0);
+                datatype = "double";
+            }
+
+            if (tsv) {
+                out += value; // Numbers and booleans are written bare in TSV
+            } else {
+                out += std::format(R"("datatype": "http://www.w3.org/2001/XMLSchema#{}", "value": "{}" }})", datatype, value);
+            }
+        }
+    }
+
+    static void appendText(std::string& out, Random& random, const SyntheticSpec& spec, bool tsv) {
+        static constexpr std::string_view kLetters = "abcdefghijklmnopqrstuvwxyz     ";
+        static constexpr std::string_view kJsonEscapes[] = { "\\\"", "\\\\", "\\n", "\\u00e9" };
+        static constexpr std::string_view kTsvEscapes[] = { "\\\"", "\\\\", "\\n", "\\t" };
+
+        for (size_t i = 0; i < spec.stringLength; ++i) {
+            if (spec.escapeDensity > 0 && random.unit() < spec.escapeDensity) {
+                out += (tsv ? kTsvEscapes : kJsonEscapes)[random.below(4)];
+            } else {
+                out += kLetters[random.below(kLetters.size())];
+            }
+        }
+    }
+};
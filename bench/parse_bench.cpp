@@ -0,0 +1,333 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <new>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "BulkExport.hpp"
+#include "SPARQReflector.hpp"
+#include "SyntheticSparql.hpp"
+
+// =============================================================================
+// Allocation counting (replaces the global operator new for this binary)
+// =============================================================================
+
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+/// Process-wide high-water mark of the resident set, in MiB.
+static double peakRssMegabytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0; // ru_maxrss is in KiB on Linux
+}
+
+// =============================================================================
+// Struct shapes
+// =============================================================================
+
+struct NarrowRow {
+    std::string name;
+    int age;
+};
+
+struct WideRow {
+    std::string label;
+    std::string description;
+    long long population;
+    double area;
+    double latitude;
+    double longitude;
+    int founded;
+    std::string country;
+};
+
+struct StringHeavyRow {
+    std::string title;
+    std::string subtitle;
+    std::string author;
+    std::string publisher;
+};
+
+/// 32 members, where per-member dispatch and per-row bookkeeping dominate.
+struct VeryWideRow {
+    std::string item;
+    std::string label;
+    std::string description;
+    std::string alias;
+    std::string country;
+    std::string region;
+    std::string city;
+    std::string website;
+    std::string image;
+    std::string category;
+    std::string language;
+    std::string license;
+    long long population;
+    long long visitors;
+    long long employees;
+    long long revenue;
+    int founded;
+    int dissolved;
+    int rank;
+    int floors;
+    double area;
+    double latitude;
+    double longitude;
+    double elevation;
+    double height;
+    double budget;
+    double rating;
+    double growth;
+    bool active;
+    bool verified;
+    bool heritage;
+    bool coastal;
+};
+
+// =============================================================================
+// Parse paths
+// =============================================================================
+
+enum class ParsePath { Scan, Json, JsonParallel, JsonInPlace, Columnar, Tsv };
+
+static constexpr std::string_view pathName(ParsePath path) {
+    switch (path) {
+        case ParsePath::Scan:         return "ExtractBindings";
+        case ParsePath::Json:         return "Json";
+        case ParsePath::JsonParallel: return "JsonParallel";
+        case ParsePath::JsonInPlace:  return "JsonInPlace";
+        case ParsePath::Columnar:     return "Columnar";
+        case ParsePath::Tsv:          return "Tsv";
+    }
+    return "";
+}
+
+static ThreadPool& parallelPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+/// Key and body of the most recently generated document, shared by every shape.
+struct CurrentDocument {
+    std::string key;
+    std::string body;
+};
+
+static CurrentDocument& currentDocument() {
+    static CurrentDocument current;
+    return current;
+}
+
+/**
+ * @brief The generated document for a shape, spec and format. Only the most recent one is kept:
+ * consecutive benchmarks on the same input share it, and a new input frees the previous one
+ * first, so a run never holds more than one input document at a time.
+ */
+template <typename T>
+static const std::string& document(const SyntheticSpec& spec, bool tsv) {
+    CurrentDocument& current = currentDocument();
+    std::string key = std::format("{}|{}|{}|{}|{}|{}", typeid(T).name(), spec.rows, spec.stringLength,
+                                  spec.escapeDensity, spec.missingRatio, tsv);
+    if (key != current.key) {
+        std::string().swap(current.body); // Release before generating the next one
+        current.body = tsv ? SyntheticSparql::tsv<T>(spec) : SyntheticSparql::json<T>(spec);
+        current.key = std::move(key);
+    }
+    return current.body;
+}
+
+/**
+ * @brief Parses one generated response per iteration and reports throughput (bytes_per_second,
+ * items_per_second = rows/s), allocations per row and the peak RSS so far.
+ */
+template <typename T, ParsePath Path>
+static void parseBenchmark(benchmark::State& state, SyntheticSpec spec) {
+    const std::string& body = document<T>(spec, Path == ParsePath::Tsv);
+    size_t allocations = 0;
+
+    for (auto _ : state) {
+        const size_t before = allocationCount.load(std::memory_order_relaxed);
+        if constexpr (Path == ParsePath::Scan) {
+            auto rows = MiniSparqlParser::extractBindingViews(body);
+            benchmark::DoNotOptimize(rows.data());
+        } else if constexpr (Path == ParsePath::Json) {
+            auto rows = SparqlReflector::parseJsonResponse<T>(body);
+            benchmark::DoNotOptimize(rows.data());
+        } else if constexpr (Path == ParsePath::JsonParallel) {
+            auto rows = SparqlReflector::parseJsonResponseParallel<T>(body, parallelPool());
+            benchmark::DoNotOptimize(rows.data());
+        } else if constexpr (Path == ParsePath::JsonInPlace) {
+            auto rows = SparqlReflector::parseJsonResponseInPlace<T>(body); // Includes copying the body
+            benchmark::DoNotOptimize(rows.rows().data());
+        } else if constexpr (Path == ParsePath::Columnar) {
+            auto columns = SparqlReflector::parseJsonResponseColumnar<T>(body);
+            benchmark::DoNotOptimize(&columns);
+        } else {
+            auto rows = SparqlReflector::parseDelimitedResponse<T>(body, ResultFormat::Tsv);
+            benchmark::DoNotOptimize(rows.data());
+        }
+        allocations += allocationCount.load(std::memory_order_relaxed) - before;
+    }
+
+    const auto iterations = static_cast<int64_t>(state.iterations());
+    state.SetBytesProcessed(iterations * static_cast<int64_t>(body.size()));
+    state.SetItemsProcessed(iterations * static_cast<int64_t>(spec.rows));
+    state.counters["allocs/row"] = static_cast<double>(allocations) / static_cast<double>(state.iterations() * spec.rows);
+    state.counters["peakRSS_MB"] = peakRssMegabytes();
+}
+
+/// Input settings of a benchmark run, read from the environment (see main).
+struct BenchConfig {
+    struct Variant {
+        std::string name;
+        double escapeDensity;
+        double missingRatio;
+    };
+
+    std::vector<size_t> rowCounts;
+    size_t stringLength;
+    std::vector<Variant> variants;
+};
+
+template <typename T>
+static void registerShape(std::string_view shape, const BenchConfig& config) {
+    auto add = [&]<ParsePath Path>(const SyntheticSpec& spec, std::string_view variant) {
+        benchmark::RegisterBenchmark(
+            std::format("{}/{}/rows:{}/{}", pathName(Path), shape, spec.rows, variant),
+            [spec](benchmark::State& state) { parseBenchmark<T, Path>(state, spec); })
+            ->Unit(benchmark::kMillisecond);
+    };
+
+    for (size_t rows : config.rowCounts) {
+        for (const BenchConfig::Variant& variant : config.variants) {
+            SyntheticSpec spec{ .rows = rows, .stringLength = config.stringLength, .escapeDensity = variant.escapeDensity,
+                                .missingRatio = variant.missingRatio };
+            add.template operator()<ParsePath::Scan>(spec, variant.name);
+            add.template operator()<ParsePath::Json>(spec, variant.name);
+            add.template operator()<ParsePath::JsonParallel>(spec, variant.name);
+            add.template operator()<ParsePath::JsonInPlace>(spec, variant.name);
+            add.template operator()<ParsePath::Columnar>(spec, variant.name);
+            add.template operator()<ParsePath::Tsv>(spec, variant.name);
+        }
+    }
+}
+
+// =============================================================================
+// Export paths
+// =============================================================================
+
+static constexpr std::string_view exportName(ExportFormat format) {
+    switch (format) {
+        case ExportFormat::Ndjson: return "Ndjson";
+        case ExportFormat::Csv:    return "Csv";
+        case ExportFormat::Binary: return "Binary";
+    }
+    return "";
+}
+
+/**
+ * @brief Writes parsed rows to /dev/null once per iteration, so only formatting and the write
+ * syscalls are measured (bytes_per_second is output bytes).
+ */
+template <typename T>
+static void exportBenchmark(benchmark::State& state, SyntheticSpec spec, ExportFormat format) {
+    const std::vector<T> rows = SparqlReflector::parseJsonResponse<T>(document<T>(spec, false));
+    OutputSink sink(std::filesystem::path("/dev/null"));
+
+    for (auto _ : state) {
+        BulkExporter::write<T>(sink, rows, format);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(sink.bytesWritten()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(rows.size()));
+}
+
+template <typename T>
+static void registerExports(std::string_view shape, const BenchConfig& config) {
+    for (size_t rows : config.rowCounts) {
+        const SyntheticSpec spec{ .rows = rows, .stringLength = config.stringLength, .escapeDensity = 0.02, .missingRatio = 0.0 };
+        for (ExportFormat format : {ExportFormat::Ndjson, ExportFormat::Csv, ExportFormat::Binary}) {
+            benchmark::RegisterBenchmark(
+                std::format("Export/{}/{}/rows:{}", exportName(format), shape, rows),
+                [spec, format](benchmark::State& state) { exportBenchmark<T>(state, spec, format); })
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+/// Row counts from SPARQ_BENCH_ROWS (comma separated, e.g. "1000,10000000"), or the defaults.
+static std::vector<size_t> rowCountsFromEnvironment() {
+    const char* value = std::getenv("SPARQ_BENCH_ROWS");
+    if (!value || !*value) return { 1000, 100000, 1000000 };
+
+    std::vector<size_t> counts;
+    std::string_view list(value);
+    while (!list.empty()) {
+        const size_t comma = std::min(list.find(','), list.size());
+        counts.push_back(std::strtoull(std::string(list.substr(0, comma)).c_str(), nullptr, 10));
+        list.remove_prefix(std::min(comma + 1, list.size()));
+    }
+    return counts;
+}
+
+/// @return The value of @p name parsed as a number, or @p fallback if it is unset or empty.
+static double numberFromEnvironment(const char* name, double fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? std::strtod(value, nullptr) : fallback;
+}
+
+/**
+ * @brief Reads the run settings. SPARQ_BENCH_STRING_LENGTH sets the characters per string value
+ * (default 24). Setting SPARQ_BENCH_ESCAPE_DENSITY or SPARQ_BENCH_MISSING_RATIO replaces the two
+ * default variants ("clean" and "escaped+optional") with a single one using those values.
+ */
+static BenchConfig configFromEnvironment() {
+    BenchConfig config{
+        .rowCounts = rowCountsFromEnvironment(),
+        .stringLength = static_cast<size_t>(numberFromEnvironment("SPARQ_BENCH_STRING_LENGTH", 24)),
+        .variants = { { "clean", 0.0, 0.0 }, { "escaped+optional", 0.02, 0.1 } },
+    };
+
+    const char* escapes = std::getenv("SPARQ_BENCH_ESCAPE_DENSITY");
+    const char* missing = std::getenv("SPARQ_BENCH_MISSING_RATIO");
+    if ((escapes && *escapes) || (missing && *missing)) {
+        const double escapeDensity = numberFromEnvironment("SPARQ_BENCH_ESCAPE_DENSITY", 0.0);
+        const double missingRatio = numberFromEnvironment("SPARQ_BENCH_MISSING_RATIO", 0.0);
+        config.variants = { { std::format("escapes:{}+missing:{}", escapeDensity, missingRatio), escapeDensity, missingRatio } };
+    }
+    return config;
+}
+
+int main(int argc, char** argv) {
+    const BenchConfig config = configFromEnvironment();
+    registerShape<NarrowRow>("Narrow", config);
+    registerShape<WideRow>("Wide", config);
+    registerShape<VeryWideRow>("VeryWide", config);
+    registerShape<StringHeavyRow>("StringHeavy", config);
+    registerExports<WideRow>("Wide", config);
+    registerExports<StringHeavyRow>("StringHeavy", config);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <exception>
+#include <format>
+#include <future>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "BatchQueryExecutor.hpp"
+#include "QueryTemplate.hpp"
+#include "SPARQReflector.hpp"
+
+/**
+ * @brief Resolves many keys with a few VALUES queries instead of one query per key.
+ * The query contains the token {values}, which is replaced by a block such as
+ * VALUES ?item { wd:Q1 wd:Q2 ... }. The variable is the member @p KeyMember of T. Keys are
+ * split into chunks that keep each request URL under Options::maxUrlLength and each query
+ * under Options::maxKeysPerChunk keys, which bounds its cost against the endpoint timeout.
+ * The chunks run concurrently on a BatchQueryExecutor, and their rows are routed back to the
+ * key they belong to.
+ * @code
+ * struct Entity { std::string item; std::string itemLabel; };
+ * BatchLookup<Entity, ^^Entity::item> lookup(executor,
+ *     R"(SELECT ?item ?itemLabel WHERE { {values} ?item rdfs:label ?itemLabel. FILTER(LANG(?itemLabel) = "en") })");
+ * std::vector<std::vector<Entity>> perKey = lookup.fetch(ids); // perKey[i] belongs to ids[i]
+ * @endcode
+ */
+template <typename T, meta::info KeyMember>
+class BatchLookup {
+    static_assert(meta::parent_of(KeyMember) == ^^T, "KeyMember must be a member of T, e.g. ^^T::item");
+
+public:
+    struct Options {
+        ResultFormat format = ResultFormat::Json;
+        /// Written before every key, e.g. "wd:" for Wikidata item IDs.
+        std::string keyPrefix = "wd:";
+        /// Upper bound on the full request URL (many servers and proxies reject URLs over 8 KiB).
+        size_t maxUrlLength = 7000;
+        /// Upper bound on keys per query, independent of their length.
+        size_t maxKeysPerChunk = 200;
+    };
+
+    /**
+     * @param executor Runs the chunk queries; must outlive this object.
+     * @param queryTemplate A complete query containing the token {values} once.
+     */
+    BatchLookup(BatchQueryExecutor& executor, std::string queryTemplate, Options opts = {})
+        : executor(executor), options(std::move(opts)) {
+        const size_t at = queryTemplate.find(kValuesToken);
+        if (at == std::string::npos) throw std::invalid_argument("BatchLookup: query has no {values} token");
+        before = queryTemplate.substr(0, at) + std::format("VALUES ?{} {{ ", kVariable);
+        after = " }" + queryTemplate.substr(at + kValuesToken.size());
+    }
+
+    /**
+     * @brief Splits @p keys into chunk queries (duplicates are sent once).
+     * @throws std::invalid_argument for a key that is not a plain local name (see Placeholder::Id).
+     * @throws std::length_error if a single key does not fit in Options::maxUrlLength.
+     */
+    std::vector<std::string> chunkQueries(std::span<const std::string> keys) const {
+        const size_t fixedLength = executor.endpoint().size() + std::string_view("?query=").size() +
+                                   encodedLength(before) + encodedLength(after);
+        std::vector<std::string> queries;
+        std::string query;
+        size_t length = 0, count = 0;
+        std::unordered_set<std::string_view> sent;
+
+        for (const std::string& key : keys) {
+            if (!sent.insert(key).second) continue;
+            std::string term;
+            QueryText::appendTerm(term, Placeholder::Id, key); // Validates; local names need no encoding
+            term = options.keyPrefix + term + ' ';
+            const size_t termLength = encodedLength(term);
+            if (fixedLength + termLength > options.maxUrlLength) {
+                throw std::length_error(std::format("BatchLookup: key '{}' does not fit in a {} byte URL", key, options.maxUrlLength));
+            }
+
+            if (count && (fixedLength + length + termLength > options.maxUrlLength || count == options.maxKeysPerChunk)) {
+                queries.push_back(before + query + after);
+                query.clear();
+                length = count = 0;
+            }
+            query += term;
+            length += termLength;
+            ++count;
+        }
+        if (count) queries.push_back(before + query + after);
+        return queries;
+    }
+
+    /**
+     * @brief Runs every chunk concurrently and returns the rows of each key.
+     * @return One vector per entry of @p keys, in the same order (empty for keys without rows).
+     * @throws The first chunk failure (see BatchQueryExecutor::submit) after all chunks finish.
+     */
+    std::vector<std::vector<T>> fetch(std::span<const std::string> keys) {
+        std::vector<std::future<std::vector<T>>> chunks;
+        for (const std::string& query : chunkQueries(keys)) {
+            chunks.push_back(executor.submit<T>(query, options.format));
+        }
+
+        std::vector<T> rows;
+        std::exception_ptr failure;
+        for (auto& chunk : chunks) {
+            try {
+                std::vector<T> part = chunk.get();
+                rows.insert(rows.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+            } catch (...) {
+                if (!failure) failure = std::current_exception();
+            }
+        }
+        if (failure) std::rethrow_exception(failure);
+        return demultiplex(keys, std::move(rows));
+    }
+
+    /**
+     * @brief Routes rows to the keys they were fetched for.
+     * A row belongs to a key when the local name of its key member (the text after the last
+     * '/', '#' or ':') equals the key, so "http://www.wikidata.org/entity/Q42" matches "Q42".
+     * Rows of a key listed twice are copied to both positions.
+     */
+    static std::vector<std::vector<T>> demultiplex(std::span<const std::string> keys, std::vector<T> rows) {
+        std::vector<std::vector<T>> perKey(keys.size());
+        std::unordered_map<std::string_view, size_t> firstIndex;
+        for (size_t i = 0; i < keys.size(); ++i) firstIndex.emplace(keys[i], i);
+
+        for (T& row : rows) {
+            if (auto it = firstIndex.find(localName(keyOf(row))); it != firstIndex.end()) {
+                perKey[it->second].push_back(std::move(row));
+            }
+        }
+        for (size_t i = 0; i < keys.size(); ++i) {
+            const size_t first = firstIndex.at(keys[i]);
+            if (first != i) perKey[i] = perKey[first];
+        }
+        return perKey;
+    }
+
+private:
+    static constexpr std::string_view kValuesToken = "{values}";
+    static constexpr std::string_view kVariable = meta::identifier_of(KeyMember);
+
+    static std::string_view keyOf(const T& row) {
+        using K = typename [: meta::type_of(KeyMember) :];
+        static_assert(std::is_convertible_v<const K&, std::string_view>, "KeyMember must hold text (std::string)");
+        return std::string_view(row.[:KeyMember:]);
+    }
+
+    static std::string_view localName(std::string_view value) {
+        const size_t cut = value.find_last_of("/#:");
+        return cut == std::string_view::npos ? value : value.substr(cut + 1);
+    }
+
+    static size_t encodedLength(std::string_view text) {
+        size_t length = 0;
+        for (char c : text) length += QueryText::isUnreserved(c) ? 1 : 3;
+        return length;
+    }
+
+    BatchQueryExecutor& executor;
+    Options options;
+    std::string before; ///< Query text up to and including "VALUES ?var { "
+    std::string after;  ///< " }" and the rest of the query
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <deque>
+#include <format>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "NetworkClient.hpp"
+#include "SPARQReflector.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Runs many independent SPARQL queries concurrently over a single curl_multi handle.
+ * Queries with different result types can be mixed in one batch: every submit<T>() returns a
+ * std::future<std::vector<T>>. A dedicated thread drives the transfers and keeps at most
+ * Options::maxInFlight requests open. Each response is parsed on a worker pool as soon as it
+ * completes, so parsing overlaps the transfers still running.
+ */
+class BatchQueryExecutor {
+public:
+    struct Options {
+        /// Maximum number of concurrent HTTP requests.
+        size_t maxInFlight = 8;
+        /// Parser threads; 0 means one per hardware thread.
+        size_t parseThreads = 0;
+        /// SPARQL endpoint every query is sent to.
+        std::string endpoint = std::string(SparqlReflector::kDefaultEndpoint);
+    };
+
+    BatchQueryExecutor() : BatchQueryExecutor(Options{}) {}
+
+    explicit BatchQueryExecutor(Options opts)
+        : options(std::move(opts)), parsers(options.parseThreads), multi(curl_multi_init()) {
+        driver = std::thread([this] { driveTransfers(); });
+    }
+
+    /**
+     * @brief Waits until every submitted query has been transferred and parsed.
+     */
+    ~BatchQueryExecutor() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        curl_multi_wakeup(multi);
+        driver.join();
+        curl_multi_cleanup(multi);
+    }
+
+    BatchQueryExecutor(const BatchQueryExecutor&) = delete;
+    BatchQueryExecutor& operator=(const BatchQueryExecutor&) = delete;
+
+    /**
+     * @brief Queues a raw SPARQL query whose rows are parsed into T.
+     * @param format Result serialization to request; TSV/CSV transfer and parse faster than JSON.
+     * @return std::future<std::vector<T>> Ready once the response has been parsed. Transport
+     * failures and non-2xx responses surface as std::runtime_error from get().
+     */
+    template <typename T>
+    std::future<std::vector<T>> submit(const std::string& query, ResultFormat format = ResultFormat::Json) {
+        auto promise = std::make_shared<std::promise<std::vector<T>>>();
+        std::future<std::vector<T>> result = promise->get_future();
+
+        auto job = std::make_unique<Job>();
+        job->url = SparqlReflector::buildQueryUrl(options.endpoint, query);
+        job->format = format;
+        job->onDone = [promise, format](std::string body, std::string error) {
+            if (!error.empty()) {
+                promise->set_exception(std::make_exception_ptr(std::runtime_error(error)));
+                return;
+            }
+            try {
+                promise->set_value(SparqlReflector::parseResponse<T>(body, format));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        };
+
+        enqueue(std::move(job));
+        return result;
+    }
+
+    /**
+     * @brief Queues a query whose SELECT clause is generated from T (see buildSimpleQuery).
+     */
+    template <typename T>
+    std::future<std::vector<T>> submitSimple(std::string_view whereClause, int limit = 10, ResultFormat format = ResultFormat::Json) {
+        return submit<T>(SparqlReflector::buildSimpleQuery<T>(whereClause, limit), format);
+    }
+
+    /// Endpoint every query is sent to.
+    [[nodiscard]] const std::string& endpoint() const { return options.endpoint; }
+
+private:
+    /// One queued or running request; owned by the easy handle (CURLOPT_PRIVATE) while in flight.
+    struct Job {
+        std::string url;
+        ResultFormat format = ResultFormat::Json;
+        std::string body;
+        std::function<void(std::string body, std::string error)> onDone;
+    };
+
+    void enqueue(std::unique_ptr<Job> job) {
+        {
+            std::lock_guard lock(mutex);
+            queued.push_back(std::move(job));
+        }
+        curl_multi_wakeup(multi);
+    }
+
+    /// Event loop of the driver thread; returns once stopping and fully drained.
+    void driveTransfers() {
+        NetworkClient client;
+        size_t inFlight = 0;
+
+        while (true) {
+            // 1. Start queued jobs while below the in-flight cap
+            std::vector<std::unique_ptr<Job>> starting;
+            {
+                std::lock_guard lock(mutex);
+                while (inFlight + starting.size() < options.maxInFlight && !queued.empty()) {
+                    starting.push_back(std::move(queued.front()));
+                    queued.pop_front();
+                }
+                if (stopping && starting.empty() && queued.empty() && inFlight == 0) return;
+            }
+            for (auto& job : starting) {
+                if (start(client, std::move(job))) ++inFlight;
+            }
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+
+            // 2. Hand completed transfers to the parser pool
+            bool finishedAny = false;
+            int remaining = 0;
+            while (CURLMsg* message = curl_multi_info_read(multi, &remaining)) {
+                if (message->msg != CURLMSG_DONE) continue;
+                finish(client, message->easy_handle, message->data.result);
+                --inFlight;
+                finishedAny = true;
+            }
+
+            // 3. Sleep until socket activity or a wakeup, unless freed slots can be refilled now
+            if (!finishedAny) {
+                curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+            }
+        }
+    }
+
+    bool start(NetworkClient& client, std::unique_ptr<Job> job) {
+        CURL* curl = client.acquireHandle();
+        if (!curl) {
+            complete(std::move(job), "curl: failed to create an easy handle");
+            return false;
+        }
+
+        client.configureGet(curl, job->url, NetworkClient::WriteCallback, &job->body, job->format);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, job.release());
+        curl_multi_add_handle(multi, curl);
+        return true;
+    }
+
+    void finish(NetworkClient& client, CURL* curl, CURLcode result) {
+        char* priv = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_PRIVATE, &priv);
+        std::unique_ptr<Job> job(reinterpret_cast<Job*>(priv));
+
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        Metrics::recordTransfer(curl, result);
+
+        curl_multi_remove_handle(multi, curl);
+        client.releaseHandle(curl);
+
+        std::string error;
+        if (result != CURLE_OK) {
+            error = std::format("curl: {}", curl_easy_strerror(result));
+        } else if (status < 200 || status >= 300) {
+            error = std::format("HTTP status {}", status);
+        }
+        complete(std::move(job), std::move(error));
+    }
+
+    void complete(std::unique_ptr<Job> job, std::string error) {
+        parsers.submit([job = std::move(job), error = std::move(error)]() mutable {
+            job->onDone(std::move(job->body), std::move(error));
+        });
+    }
+
+    Options options;
+    ThreadPool parsers;
+    CURLM* multi = nullptr;
+    std::thread driver;
+
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Job>> queued;
+    bool stopping = false;
+};
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Interned.hpp"
+#include "LiteralDecoder.hpp"
+#include "SPARQReflector.hpp"
+
+namespace reflection_impl {
+    /// Temp file next to @p path, unique per process and write, so concurrent writers never share one.
+    inline std::filesystem::path snapshotTempPath(const std::filesystem::path& path) {
+        static std::atomic<std::uint64_t> counter{0};
+        std::filesystem::path temp = path;
+        temp += std::format(".{}.{}.tmp", ::getpid(), counter.fetch_add(1, std::memory_order_relaxed));
+        return temp;
+    }
+
+    /// Location of one text value in the string heap of a snapshot file.
+    struct HeapSlice {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    /// Text members (strings, views, Interned, char buffers) are stored as HeapSlice.
+    template <typename V>
+    consteval bool isSnapshotText() {
+        return LiteralDecoder::isSpecializationOf<V, ^^Interned>() || LiteralDecoder::isCharBuffer<V>() ||
+               std::is_convertible_v<const V&, std::string_view>;
+    }
+
+    /// Fixed-width cell type of a member of type V (an optional is stored as its value plus a validity bit).
+    template <typename V>
+    consteval meta::info snapshotCellOf() {
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            return snapshotCellOf<typename V::value_type>();
+        } else if constexpr (isSnapshotText<V>()) {
+            return ^^HeapSlice;
+        } else if constexpr (LiteralDecoder::isSystemTimePoint<V>()) {
+            return ^^typename V::rep;
+        } else {
+            static_assert(std::is_arithmetic_v<V> || std::is_enum_v<V>,
+                          "Unsupported member type for BinarySnapshot (nested groups must be stored as their own snapshot)");
+            return ^^V;
+        }
+    }
+
+    template <typename V>
+    using SnapshotCell = typename [: snapshotCellOf<V>() :];
+}
+
+/**
+ * @brief Flat, schema-checked binary file of a std::vector<T>, read in place through mmap.
+ * Every member of T becomes a fixed-width column; text goes into one string heap and the column
+ * holds its offset and size; std::optional members add a validity bitmap. The header carries
+ * SparqlReflector::layoutFingerprint<T>(), so a file written for another layout of T is rejected
+ * instead of misread. Opening maps the file and checks the header; nothing is decoded, so rows
+ * are read straight from the page cache, which processes opening the same file share.
+ * Files use the native byte order and are only portable between machines of the same one.
+ * @code
+ * BinarySnapshot<RiverInfo>::write("rivers.snap", rivers);
+ * if (auto snapshot = BinarySnapshot<RiverInfo>::open("rivers.snap")) {
+ *     std::string_view label = snapshot->get<^^RiverInfo::riverLabel>(0);
+ * }
+ * @endcode
+ */
+template <typename T>
+class BinarySnapshot {
+public:
+    static constexpr std::uint64_t kFingerprint = SparqlReflector::layoutFingerprint<T>();
+
+    /**
+     * @brief Writes @p rows to @p path (atomically, via rename).
+     * @throws std::system_error if the file cannot be written.
+     */
+    static void write(const std::filesystem::path& path, std::span<const T> rows) {
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.byteOrder = kByteOrder;
+        header.columnCount = kColumns;
+        header.fingerprint = kFingerprint;
+        header.rowCount = rows.size();
+
+        std::vector<ColumnEntry> directory(kColumns);
+        std::vector<std::string> sections(kColumns);
+        std::string heap;
+        size_t offset = align(sizeof(Header) + sizeof(ColumnEntry) * kColumns);
+
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((offset = encodeColumn<I>(rows, directory[I], sections[I], heap, offset)), ...);
+        }(std::make_index_sequence<kColumns>{});
+        header.heapOffset = offset;
+        header.heapSize = heap.size();
+        header.fileSize = offset + heap.size();
+
+        const std::filesystem::path temp = reflection_impl::snapshotTempPath(path);
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(directory.data()), static_cast<std::streamsize>(sizeof(ColumnEntry) * kColumns));
+            size_t written = sizeof(Header) + sizeof(ColumnEntry) * kColumns;
+            for (size_t i = 0; i < kColumns; ++i) {
+                out.write(kPadding, static_cast<std::streamsize>(directory[i].valuesOffset - written));
+                out.write(sections[i].data(), static_cast<std::streamsize>(sections[i].size()));
+                written = directory[i].valuesOffset + sections[i].size();
+            }
+            out.write(kPadding, static_cast<std::streamsize>(header.heapOffset - written));
+            out.write(heap.data(), static_cast<std::streamsize>(heap.size()));
+            if (!out) {
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(temp, ec);
+                throw std::system_error(errno ? errno : EIO, std::generic_category(), "BinarySnapshot: write failed");
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::error_code ignored;
+            std::filesystem::remove(temp, ignored);
+            throw std::system_error(ec, "BinarySnapshot: rename failed");
+        }
+    }
+
+    /**
+     * @brief Maps the snapshot at @p path.
+     * @return std::nullopt if the file is missing, truncated, or written for another layout of T
+     * (callers then fall back to querying the endpoint).
+     */
+    static std::optional<BinarySnapshot> open(const std::filesystem::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return std::nullopt;
+
+        struct stat info {};
+        void* mapping = MAP_FAILED;
+        if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(Header) + sizeof(ColumnEntry) * kColumns) {
+            mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd); // The mapping stays valid on its own
+        if (mapping == MAP_FAILED) return std::nullopt;
+
+        BinarySnapshot snapshot(mapping, static_cast<size_t>(info.st_size));
+        if (!snapshot.valid()) return std::nullopt;
+        return snapshot;
+    }
+
+    BinarySnapshot(BinarySnapshot&& other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr)), mappingSize(other.mappingSize) {}
+
+    BinarySnapshot& operator=(BinarySnapshot&&) = delete;
+    BinarySnapshot(const BinarySnapshot&) = delete;
+
+    ~BinarySnapshot() {
+        if (mapping) ::munmap(mapping, mappingSize);
+    }
+
+    [[nodiscard]] size_t size() const { return static_cast<size_t>(header().rowCount); }
+
+    /**
+     * @brief Raw cells of @p Member, in row order (HeapSlice for text, the rep of time points).
+     */
+    template <meta::info Member>
+    [[nodiscard]] std::span<const reflection_impl::SnapshotCell<typename [: meta::type_of(Member) :]>> column() const {
+        static_assert(meta::parent_of(Member) == ^^T, "Member must be a member of T, e.g. ^^T::item");
+        using Cell = reflection_impl::SnapshotCell<typename [: meta::type_of(Member) :]>;
+        return std::span(reinterpret_cast<const Cell*>(base() + entry(indexOf<Member>()).valuesOffset), size());
+    }
+
+    /**
+     * @brief Value of @p Member in @p row, read in place.
+     * Text is returned as a std::string_view into the mapping, so it lives as long as the snapshot;
+     * optional members return std::optional of that view type.
+     */
+    template <meta::info Member>
+    [[nodiscard]] auto get(size_t row) const {
+        using V = typename [: meta::type_of(Member) :];
+        const auto& cell = column<Member>()[row];
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            using View = decltype(view<typename V::value_type>(cell));
+            return present(indexOf<Member>(), row) ? std::optional<View>(view<typename V::value_type>(cell)) : std::nullopt;
+        } else {
+            return view<V>(cell);
+        }
+    }
+
+    /// Copies @p row out of the mapping (std::string_view members still point into it).
+    [[nodiscard]] T row(size_t index) const {
+        T item{};
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (materialize<I>(item, index), ...);
+        }(std::make_index_sequence<kColumns>{});
+        return item;
+    }
+
+    [[nodiscard]] std::vector<T> toVector() const {
+        std::vector<T> rows;
+        rows.reserve(size());
+        for (size_t i = 0; i < size(); ++i) rows.push_back(row(i));
+        return rows;
+    }
+
+private:
+    static constexpr char kMagic[8] = {'S', 'P', 'Q', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::uint32_t kByteOrder = 0x01020304;
+    static constexpr size_t kColumns = reflection_impl::MemberDispatch<T>::count;
+    static constexpr size_t kAlignment = 8;
+    static constexpr char kPadding[kAlignment] = {};
+
+    /// File layout: header, column directory, column sections (each 8-byte aligned), string heap.
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint64_t fingerprint;
+        std::uint64_t rowCount;
+        std::uint64_t columnCount;
+        std::uint64_t heapOffset;
+        std::uint64_t heapSize;
+        std::uint64_t fileSize;
+    };
+
+    struct ColumnEntry {
+        std::uint64_t valuesOffset;
+        std::uint64_t validityOffset; ///< Bitmap words of an optional member, 0 otherwise
+        std::uint64_t width;          ///< Bytes per cell
+    };
+
+    BinarySnapshot(void* mapping, size_t mappingSize) : mapping(mapping), mappingSize(mappingSize) {}
+
+    static constexpr size_t align(size_t offset) {
+        return (offset + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    template <meta::info Member>
+    static consteval size_t indexOf() {
+        const auto& members = reflection_impl::MemberDispatch<T>::members;
+        for (size_t i = 0; i < members.size(); ++i) {
+            if (members[i] == Member) return i;
+        }
+        return kColumns;
+    }
+
+    // Appends the cells of member I (and its validity bitmap) to section; returns the offset after it
+    template <size_t I>
+    static size_t encodeColumn(std::span<const T> rows, ColumnEntry& entry, std::string& section,
+                               std::string& heap, size_t offset) {
+        using V = reflection_impl::MemberTypeAt<T, I>;
+        using Cell = reflection_impl::SnapshotCell<V>;
+        constexpr auto member = reflection_impl::MemberDispatch<T>::members[I];
+
+        entry.valuesOffset = offset;
+        entry.width = sizeof(Cell);
+        section.resize(align(sizeof(Cell) * rows.size()));
+        ValidityBitmap validity;
+
+        for (size_t row = 0; row < rows.size(); ++row) {
+            const V& value = rows[row].[:member:];
+            Cell cell{};
+            if constexpr (LiteralDecoder::isOptional<V>) {
+                validity.push_back(value.has_value());
+                if (value) cell = encodeCell(*value, heap);
+            } else {
+                cell = encodeCell(value, heap);
+            }
+            std::memcpy(section.data() + row * sizeof(Cell), &cell, sizeof(Cell));
+        }
+
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            entry.validityOffset = offset + section.size();
+            const auto& words = validity.data();
+            section.append(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint64_t));
+        }
+        return offset + section.size();
+    }
+
+    template <typename V>
+    static reflection_impl::SnapshotCell<V> encodeCell(const V& value, std::string& heap) {
+        if constexpr (reflection_impl::isSnapshotText<V>()) {
+            std::string_view text;
+            if constexpr (LiteralDecoder::isSpecializationOf<V, ^^Interned>()) text = value.view();
+            else if constexpr (LiteralDecoder::isCharBuffer<V>()) text = LiteralDecoder::bufferText(value);
+            else text = std::string_view(value);
+            const reflection_impl::HeapSlice slice{heap.size(), text.size()};
+            heap.append(text);
+            return slice;
+        } else if constexpr (LiteralDecoder::isSystemTimePoint<V>()) {
+            return value.time_since_epoch().count();
+        } else {
+            return value;
+        }
+    }
+
+    // In-place view of a cell: string_view for text, the decoded value otherwise
+    template <typename V>
+    auto view(const reflection_impl::SnapshotCell<V>& cell) const {
+        if constexpr (reflection_impl::isSnapshotText<V>()) {
+            return heap().substr(cell.offset, cell.size);
+        } else if constexpr (LiteralDecoder::isSystemTimePoint<V>()) {
+            return V(typename V::duration(cell));
+        } else {
+            return cell;
+        }
+    }
+
+    template <size_t I>
+    void materialize(T& item, size_t row) const {
+        using V = reflection_impl::MemberTypeAt<T, I>;
+        constexpr auto member = reflection_impl::MemberDispatch<T>::members[I];
+        const auto& cell = reinterpret_cast<const reflection_impl::SnapshotCell<V>*>(base() + entry(I).valuesOffset)[row];
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            using Inner = typename V::value_type;
+            if (present(I, row)) item.[:member:] = fromView<Inner>(view<Inner>(cell));
+        } else if constexpr (LiteralDecoder::isCharBuffer<V>()) {
+            const std::string_view text = view<V>(cell);
+            auto& buffer = item.[:member:];
+            std::fill(std::begin(buffer), std::end(buffer), '\0');
+            std::memcpy(std::data(buffer), text.data(), std::min(text.size(), std::size(buffer)));
+        } else {
+            item.[:member:] = fromView<V>(view<V>(cell));
+        }
+    }
+
+    template <typename V, typename View>
+    static V fromView(const View& value) {
+        if constexpr (reflection_impl::isSnapshotText<V>() && !std::is_same_v<V, std::string_view>) return V(value);
+        else return value;
+    }
+
+    [[nodiscard]] bool present(size_t column, size_t row) const {
+        const auto* words = reinterpret_cast<const std::uint64_t*>(base() + entry(column).validityOffset);
+        return (words[row / 64] >> (row % 64)) & 1;
+    }
+
+    // Header and directory checks; column and heap bounds must lie inside the file
+    [[nodiscard]] bool valid() const {
+        const Header& h = header();
+        if (std::memcmp(h.magic, kMagic, sizeof(h.magic)) != 0 || h.version != kVersion || h.byteOrder != kByteOrder ||
+            h.fingerprint != kFingerprint || h.columnCount != kColumns || h.fileSize != mappingSize ||
+            h.heapOffset > mappingSize || h.heapSize > mappingSize - h.heapOffset) {
+            return false;
+        }
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return (validColumn<I>() && ...);
+        }(std::make_index_sequence<kColumns>{});
+    }
+
+    template <size_t I>
+    [[nodiscard]] bool validColumn() const {
+        using V = reflection_impl::MemberTypeAt<T, I>;
+        const ColumnEntry& column = entry(I);
+        const std::uint64_t rows = header().rowCount;
+        const bool values = column.width == sizeof(reflection_impl::SnapshotCell<V>) &&
+                            column.valuesOffset % kAlignment == 0 && column.valuesOffset <= mappingSize &&
+                            rows <= (mappingSize - column.valuesOffset) / column.width;
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            const std::uint64_t bitmapBytes = (rows + 63) / 64 * sizeof(std::uint64_t);
+            return values && column.validityOffset % kAlignment == 0 && column.validityOffset <= mappingSize &&
+                   bitmapBytes <= mappingSize - column.validityOffset;
+        }
+        return values;
+    }
+
+    [[nodiscard]] const char* base() const { return static_cast<const char*>(mapping); }
+    [[nodiscard]] const Header& header() const { return *reinterpret_cast<const Header*>(base()); }
+
+    [[nodiscard]] const ColumnEntry& entry(size_t column) const {
+        return reinterpret_cast<const ColumnEntry*>(base() + sizeof(Header))[column];
+    }
+
+    /// Out-of-range slices throw std::out_of_range from substr instead of reading past the heap.
+    [[nodiscard]] std::string_view heap() const {
+        return std::string_view(base() + header().heapOffset, header().heapSize);
+    }
+
+    void* mapping;
+    size_t mappingSize;
+};
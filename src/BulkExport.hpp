@@ -0,0 +1,469 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "Interned.hpp"
+#include "LiteralDecoder.hpp"
+#include "Metrics.hpp"
+#include "SPARQReflector.hpp"
+
+enum class ExportFormat { Ndjson, Csv, Binary };
+
+/**
+ * @brief Buffered output to a file descriptor (file, pipe or stdout).
+ * Writers format into one large reusable buffer and call commit() after each row; the buffer is
+ * handed to the kernel once it reaches its capacity, so a million rows cost a few hundred
+ * syscalls instead of several per row. Large values can be queued by reference and go out in
+ * the same writev() as the surrounding buffer, without being copied.
+ */
+class OutputSink {
+public:
+    static constexpr size_t kDefaultCapacity = size_t{1} << 20;
+
+    /// Writes to an open descriptor (e.g. STDOUT_FILENO or a pipe) without taking ownership.
+    explicit OutputSink(int fd, size_t capacity = kDefaultCapacity) : fd(fd), capacity(capacity) {
+        buffer.reserve(capacity + capacity / 4);
+    }
+
+    /**
+     * @brief Creates or truncates @p path.
+     * @throws std::system_error if the file cannot be opened.
+     */
+    explicit OutputSink(const std::filesystem::path& path, size_t capacity = kDefaultCapacity)
+        : OutputSink(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644), capacity) {
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), std::format("OutputSink: cannot open {}", path.string()));
+        owned = true;
+    }
+
+    /// Flushes what is left; errors at this point are dropped, so call flush() to see them.
+    ~OutputSink() {
+        try {
+            flush();
+        } catch (...) {
+        }
+        if (owned) ::close(fd);
+    }
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    /// The formatting buffer; append to it, then call commit().
+    [[nodiscard]] std::string& data() { return buffer; }
+
+    /// Flushes once the buffer (or the queue of referenced values) is full.
+    void commit() {
+        if (buffer.size() >= capacity || pieces.size() >= kMaxIov) flush();
+    }
+
+    /**
+     * @brief Queues @p bytes after the buffer contents so far, without copying them.
+     * They must stay valid until the next flush().
+     */
+    void reference(std::string_view bytes) {
+        seal();
+        pieces.push_back(Piece{bytes.data(), 0, bytes.size()});
+        referenced += bytes.size();
+    }
+
+    /// Bytes queued through reference() since construction.
+    [[nodiscard]] std::uint64_t referencedBytes() const { return referenced; }
+
+    /// Bytes handed to the kernel so far.
+    [[nodiscard]] std::uint64_t bytesWritten() const { return written; }
+
+    /**
+     * @brief Writes everything queued, in batches of up to kMaxIov vectors per writev().
+     * Partial writes and EINTR are retried.
+     * @throws std::system_error on a write error (e.g. EPIPE or ENOSPC).
+     */
+    void flush() {
+        seal();
+        if (pieces.empty()) return;
+
+        std::vector<iovec> vectors;
+        vectors.reserve(pieces.size());
+        for (const Piece& piece : pieces) {
+            const char* bytes = piece.external ? piece.external : buffer.data() + piece.offset;
+            vectors.push_back(iovec{const_cast<char*>(bytes), piece.size});
+        }
+
+        for (size_t first = 0; first < vectors.size();) {
+            const int count = static_cast<int>(std::min(vectors.size() - first, kMaxIov));
+            const ssize_t result = ::writev(fd, vectors.data() + first, count);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "OutputSink: write failed");
+            }
+            written += static_cast<std::uint64_t>(result);
+
+            // Skip the vectors written completely and trim a partially written one
+            for (size_t remaining = static_cast<size_t>(result); remaining > 0;) {
+                iovec& vector = vectors[first];
+                if (remaining >= vector.iov_len) {
+                    remaining -= vector.iov_len;
+                    ++first;
+                } else {
+                    vector.iov_base = static_cast<char*>(vector.iov_base) + remaining;
+                    vector.iov_len -= remaining;
+                    remaining = 0;
+                }
+            }
+        }
+        buffer.clear();
+        pieces.clear();
+        sealed = 0;
+    }
+
+private:
+    /// Linux accepts at most 1024 vectors per writev() (UIO_MAXIOV).
+    static constexpr size_t kMaxIov = 1024;
+
+    /// Either buffer[offset, offset + size) or external bytes.
+    struct Piece {
+        const char* external;
+        size_t offset;
+        size_t size;
+    };
+
+    // Closes the buffer bytes appended since the last piece into a piece of their own
+    void seal() {
+        if (buffer.size() > sealed) {
+            pieces.push_back(Piece{nullptr, sealed, buffer.size() - sealed});
+            sealed = buffer.size();
+        }
+    }
+
+    int fd;
+    bool owned = false;
+    size_t capacity;
+    std::string buffer;
+    std::vector<Piece> pieces;
+    size_t sealed = 0;
+    std::uint64_t referenced = 0;
+    std::uint64_t written = 0;
+};
+
+namespace reflection_impl {
+    /// "{\"member\":" for the first member of T, ",\"member\":" for the others.
+    template <typename T, std::size_t I>
+    constexpr std::string jsonKeyText() {
+        std::string text = I == 0 ? "{\"" : ",\"";
+        text += MemberDispatch<T>::names[I];
+        text += "\":";
+        return text;
+    }
+
+    /// "member1,member2,...\n"
+    template <typename T>
+    constexpr std::string csvHeaderText() {
+        std::string text;
+        for (std::string_view name : MemberDispatch<T>::names) {
+            if (!text.empty()) text += ',';
+            text += name;
+        }
+        text += '\n';
+        return text;
+    }
+}
+
+/**
+ * @brief Reflection-generated bulk writers for result rows.
+ * - NDJSON: one JSON object per row and line; unbound optionals and non-finite numbers are null,
+ *   enums are written by name, time points as ISO 8601 strings, child groups as arrays.
+ * - CSV (RFC 4180): a header of member names, then one line per row; fields containing a comma,
+ *   quote or line break are quoted. Unbound optionals are empty fields; child groups are rejected.
+ * - Binary: the 8 bytes "SPQROWS1" and the u64 SparqlReflector::layoutFingerprint<T>(), then per
+ *   row a u32 byte length followed by the members in declaration order. Numbers, bools (1 byte)
+ *   and enums are stored with their native width and byte order, time points as their tick
+ *   count, text as a u32 length and the bytes, optionals as a presence byte and the value, and
+ *   child groups as a u32 count and the children. The row length lets readers skip rows.
+ * Keys and the CSV header are built at compile time; values are formatted straight into the
+ * sink's buffer, and every call flushes the sink before returning.
+ */
+class BulkExporter {
+public:
+    /// Text values at least this long are written by reference in the binary format.
+    static constexpr size_t kReferenceThreshold = 4096;
+
+    template <typename T>
+    static void writeNdjson(OutputSink& sink, std::span<const T> rows) {
+        Metrics::ScopedTimer timer(Metrics::Phase::Export);
+        std::string& out = sink.data();
+        for (const T& row : rows) {
+            appendJsonObject(out, row);
+            out += '\n';
+            sink.commit();
+        }
+        sink.flush();
+    }
+
+    /// @param header Writes the line of member names first (skip it when appending further pages).
+    template <typename T>
+    static void writeCsv(OutputSink& sink, std::span<const T> rows, bool header = true) {
+        Metrics::ScopedTimer timer(Metrics::Phase::Export);
+        std::string& out = sink.data();
+        if (header) out += reflection_impl::StaticText<reflection_impl::csvHeaderText<T>>::view();
+        for (const T& row : rows) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (appendCsvMember<I>(out, row), ...);
+            }(std::make_index_sequence<reflection_impl::MemberDispatch<T>::count>{});
+            out += '\n';
+            sink.commit();
+        }
+        sink.flush();
+    }
+
+    /**
+     * @param header Writes the magic and fingerprint first (skip it when appending further pages).
+     * @throws std::length_error for a row or text value over 4 GiB.
+     */
+    template <typename T>
+    static void writeBinary(OutputSink& sink, std::span<const T> rows, bool header = true) {
+        Metrics::ScopedTimer timer(Metrics::Phase::Export);
+        std::string& out = sink.data();
+        if (header) {
+            out.append(kBinaryMagic);
+            appendRaw(out, SparqlReflector::layoutFingerprint<T>());
+        }
+        for (const T& row : rows) {
+            const size_t start = out.size();
+            const std::uint64_t referencedBefore = sink.referencedBytes();
+            appendRaw(out, std::uint32_t{0}); // Patched below
+            appendBinaryFields(sink, row);
+
+            const std::uint64_t length = out.size() - start - sizeof(std::uint32_t) + (sink.referencedBytes() - referencedBefore);
+            if (length > std::numeric_limits<std::uint32_t>::max()) throw std::length_error("BulkExporter: row over 4 GiB");
+            const auto prefix = static_cast<std::uint32_t>(length);
+            std::memcpy(out.data() + start, &prefix, sizeof(prefix));
+            sink.commit(); // Only between rows, so the prefix is still in the buffer when patched
+        }
+        sink.flush();
+    }
+
+    template <typename T>
+    static void write(OutputSink& sink, std::span<const T> rows, ExportFormat format) {
+        switch (format) {
+            case ExportFormat::Csv:    writeCsv(sink, rows); break;
+            case ExportFormat::Binary: writeBinary(sink, rows); break;
+            default:                   writeNdjson(sink, rows); break;
+        }
+    }
+
+    /// Writes @p rows to a new file at @p path. @throws std::system_error on I/O errors.
+    template <typename T>
+    static void writeFile(const std::filesystem::path& path, std::span<const T> rows, ExportFormat format) {
+        OutputSink sink(path);
+        write(sink, rows, format);
+    }
+
+    /// Appends @p text as a JSON string literal.
+    static void appendJsonString(std::string& out, std::string_view text) {
+        out += '"';
+        size_t start = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            const auto c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            out.append(text.substr(start, i - start));
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                default:   std::format_to(std::back_inserter(out), "\\u{:04x}", c); break;
+            }
+            start = i + 1;
+        }
+        out.append(text.substr(start));
+        out += '"';
+    }
+
+    /// Appends @p text as a CSV field, quoted only when it has to be.
+    static void appendCsvField(std::string& out, std::string_view text) {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out.append(text);
+            return;
+        }
+        out += '"';
+        for (size_t quote; (quote = text.find('"')) != std::string_view::npos; text.remove_prefix(quote + 1)) {
+            out.append(text.substr(0, quote + 1));
+            out += '"';
+        }
+        out.append(text);
+        out += '"';
+    }
+
+private:
+    static constexpr std::string_view kBinaryMagic = "SPQROWS1";
+
+    template <typename V>
+    static consteval bool isText() {
+        return LiteralDecoder::isSpecializationOf<V, ^^Interned>() || LiteralDecoder::isCharBuffer<V>() ||
+               std::is_convertible_v<const V&, std::string_view>;
+    }
+
+    template <typename V>
+    static std::string_view textOf(const V& value) {
+        if constexpr (LiteralDecoder::isSpecializationOf<V, ^^Interned>()) return value.view();
+        else if constexpr (LiteralDecoder::isCharBuffer<V>()) return LiteralDecoder::bufferText(value);
+        else return std::string_view(value);
+    }
+
+    template <typename V>
+    static void appendNumber(std::string& out, V value) {
+        char digits[64];
+        const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, end);
+    }
+
+    template <typename V>
+    static void appendRaw(std::string& out, const V& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    // Non-text scalars shared by NDJSON and CSV (quote wraps enum names and time points for JSON)
+    template <typename V>
+    static void appendScalar(std::string& out, const V& value, bool quote) {
+        if constexpr (std::is_same_v<V, bool>) {
+            out += value ? "true" : "false";
+        }
+        else if constexpr (std::is_enum_v<V>) {
+            const std::string_view name = LiteralDecoder::enumName(value);
+            if (name.empty()) appendNumber(out, std::to_underlying(value));
+            else if (quote) appendJsonString(out, name);
+            else appendCsvField(out, name);
+        }
+        else if constexpr (LiteralDecoder::isSystemTimePoint<V>()) {
+            if (quote) out += '"';
+            std::format_to(std::back_inserter(out), "{:%FT%TZ}", value);
+            if (quote) out += '"';
+        }
+        else if constexpr (std::is_floating_point_v<V>) {
+            if (std::isfinite(value) || !quote) appendNumber(out, value);
+            else out += "null";
+        }
+        else {
+            static_assert(std::is_integral_v<V>, "Unsupported member type for export");
+            appendNumber(out, value);
+        }
+    }
+
+    template <typename T>
+    static void appendJsonObject(std::string& out, const T& row) {
+        using Dispatch = reflection_impl::MemberDispatch<T>;
+        if constexpr (Dispatch::count == 0) out += '{';
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((out += reflection_impl::StaticText<reflection_impl::jsonKeyText<T, I>>::view(),
+              appendJsonValue(out, row.[:Dispatch::members[I]:])), ...);
+        }(std::make_index_sequence<Dispatch::count>{});
+        out += '}';
+    }
+
+    template <typename V>
+    static void appendJsonValue(std::string& out, const V& value) {
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            if (value) appendJsonValue(out, *value);
+            else out += "null";
+        }
+        else if constexpr (reflection_impl::isChildGroup<V>()) {
+            out += '[';
+            for (size_t i = 0; i < value.size(); ++i) {
+                if (i) out += ',';
+                appendJsonObject(out, value[i]);
+            }
+            out += ']';
+        }
+        else if constexpr (isText<V>()) {
+            appendJsonString(out, textOf(value));
+        }
+        else {
+            appendScalar(out, value, true);
+        }
+    }
+
+    template <std::size_t I, typename T>
+    static void appendCsvMember(std::string& out, const T& row) {
+        if constexpr (I > 0) out += ',';
+        appendCsvValue(out, row.[:reflection_impl::MemberDispatch<T>::members[I]:]);
+    }
+
+    template <typename V>
+    static void appendCsvValue(std::string& out, const V& value) {
+        static_assert(!reflection_impl::isChildGroup<V>(), "CSV cannot hold child groups; export them with NDJSON or binary");
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            if (value) appendCsvValue(out, *value);
+        }
+        else if constexpr (isText<V>()) {
+            appendCsvField(out, textOf(value));
+        }
+        else {
+            appendScalar(out, value, false);
+        }
+    }
+
+    template <typename T>
+    static void appendBinaryFields(OutputSink& sink, const T& row) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (appendBinaryValue(sink, row.[:reflection_impl::MemberDispatch<T>::members[I]:]), ...);
+        }(std::make_index_sequence<reflection_impl::MemberDispatch<T>::count>{});
+    }
+
+    template <typename V>
+    static void appendBinaryValue(OutputSink& sink, const V& value) {
+        std::string& out = sink.data();
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            out += static_cast<char>(value.has_value());
+            if (value) appendBinaryValue(sink, *value);
+        }
+        else if constexpr (reflection_impl::isChildGroup<V>()) {
+            appendRaw(out, checkedLength(value.size()));
+            for (const auto& child : value) appendBinaryFields(sink, child);
+        }
+        else if constexpr (isText<V>()) {
+            const std::string_view text = textOf(value);
+            appendRaw(out, checkedLength(text.size()));
+            // The rows outlive the flush at the end of writeBinary, so long values are not copied
+            if (text.size() >= kReferenceThreshold) sink.reference(text);
+            else out.append(text);
+        }
+        else if constexpr (std::is_same_v<V, bool>) {
+            out += static_cast<char>(value);
+        }
+        else if constexpr (LiteralDecoder::isSystemTimePoint<V>()) {
+            appendRaw(out, value.time_since_epoch().count());
+        }
+        else {
+            static_assert(std::is_arithmetic_v<V> || std::is_enum_v<V>, "Unsupported member type for export");
+            appendRaw(out, value);
+        }
+    }
+
+    static std::uint32_t checkedLength(size_t size) {
+        if (size > std::numeric_limits<std::uint32_t>::max()) throw std::length_error("BulkExporter: value over 4 GiB");
+        return static_cast<std::uint32_t>(size);
+    }
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// P2996 Standard Header
+#include <meta>
+
+/**
+ * @brief One bit per row, set when the row had a binding for the column.
+ * Missing OPTIONAL bindings leave their bit clear.
+ */
+class ValidityBitmap {
+public:
+    void push_back(bool valid) {
+        if (count % 64 == 0) words.push_back(0);
+        if (valid) words.back() |= std::uint64_t{1} << (count % 64);
+        ++count;
+    }
+
+    void reserve(size_t rows) { words.reserve((rows + 63) / 64); }
+
+    [[nodiscard]] bool operator[](size_t row) const {
+        return (words[row / 64] >> (row % 64)) & 1;
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+
+    /// Number of rows with a value.
+    [[nodiscard]] size_t countValid() const {
+        size_t valid = 0;
+        for (std::uint64_t word : words) valid += static_cast<size_t>(std::popcount(word));
+        return valid;
+    }
+
+    /// Packed words, bit (row % 64) of word (row / 64).
+    [[nodiscard]] const std::vector<std::uint64_t>& data() const { return words; }
+
+private:
+    std::vector<std::uint64_t> words;
+    size_t count = 0;
+};
+
+/**
+ * @brief Column of fixed-width values: contiguous storage plus a validity bitmap.
+ * Rows without a binding hold a value-initialized V.
+ */
+template <typename V>
+struct Column {
+    std::vector<V> values;
+    ValidityBitmap validity;
+
+    void append(V value) {
+        values.push_back(std::move(value));
+        validity.push_back(true);
+    }
+
+    void appendNull() {
+        values.emplace_back();
+        validity.push_back(false);
+    }
+
+    void reserve(size_t rows) {
+        values.reserve(rows);
+        validity.reserve(rows);
+    }
+
+    [[nodiscard]] size_t size() const { return values.size(); }
+    [[nodiscard]] bool isValid(size_t row) const { return validity[row]; }
+    [[nodiscard]] const V& operator[](size_t row) const { return values[row]; }
+};
+
+/**
+ * @brief Boolean column stored one byte per row.
+ * std::vector<bool> packs bits and hands out proxies, so it could not return a reference from
+ * operator[] nor expose contiguous values for scans.
+ */
+template <>
+struct Column<bool> {
+    std::vector<std::uint8_t> values;
+    ValidityBitmap validity;
+
+    void append(bool value) {
+        values.push_back(value ? 1 : 0);
+        validity.push_back(true);
+    }
+
+    void appendNull() {
+        values.push_back(0);
+        validity.push_back(false);
+    }
+
+    void reserve(size_t rows) {
+        values.reserve(rows);
+        validity.reserve(rows);
+    }
+
+    [[nodiscard]] size_t size() const { return values.size(); }
+    [[nodiscard]] bool isValid(size_t row) const { return validity[row]; }
+    [[nodiscard]] bool operator[](size_t row) const { return values[row] != 0; }
+};
+
+/**
+ * @brief Packed string column: every value lives in one character buffer, delimited by offsets.
+ * Row i spans chars[offsets[i], offsets[i + 1]), so there is no per-row allocation.
+ */
+template <>
+struct Column<std::string> {
+    std::vector<std::uint64_t> offsets{0};
+    std::string chars;
+    ValidityBitmap validity;
+
+    void append(std::string_view value) {
+        chars.append(value);
+        offsets.push_back(chars.size());
+        validity.push_back(true);
+    }
+
+    /**
+     * @brief Appends a value produced directly into the buffer.
+     * @param maxSize Upper bound of the value's size.
+     * @param write Called as write(char* dest) and returns the number of bytes written.
+     */
+    template <typename F>
+    void appendWith(size_t maxSize, F&& write) {
+        const size_t start = chars.size();
+        chars.resize(start + maxSize);
+        chars.resize(start + write(chars.data() + start));
+        offsets.push_back(chars.size());
+        validity.push_back(true);
+    }
+
+    void appendNull() {
+        offsets.push_back(chars.size());
+        validity.push_back(false);
+    }
+
+    void reserve(size_t rows) {
+        offsets.reserve(rows + 1);
+        validity.reserve(rows);
+    }
+
+    [[nodiscard]] size_t size() const { return offsets.size() - 1; }
+    [[nodiscard]] bool isValid(size_t row) const { return validity[row]; }
+
+    [[nodiscard]] std::string_view operator[](size_t row) const {
+        return std::string_view(chars).substr(offsets[row], offsets[row + 1] - offsets[row]);
+    }
+};
+
+namespace reflection_impl {
+    /// Value type stored in the column of a member of type V: optionals are unwrapped, since
+    /// the validity bitmap already records absence.
+    template <typename V>
+    struct ColumnValue { using type = V; };
+
+    template <typename V>
+    struct ColumnValue<std::optional<V>> { using type = V; };
+
+    template <typename V>
+    using ColumnValueT = typename ColumnValue<V>::type;
+
+    /**
+     * @brief Synthesizes the struct-of-arrays counterpart of T with define_aggregate:
+     * every member `M name;` of T becomes `Column<M> name;` (`Column<U>` for `std::optional<U>`).
+     */
+    template <typename T>
+    struct ColumnsOf {
+        struct type;
+
+        consteval {
+            std::vector<std::meta::info> columns;
+            for (auto member : std::meta::nonstatic_data_members_of(^^T, std::meta::access_context::unchecked())) {
+                auto valueType = std::meta::dealias(std::meta::substitute(^^ColumnValueT, {std::meta::dealias(std::meta::type_of(member))}));
+                auto columnType = std::meta::substitute(^^Column, {valueType});
+                columns.push_back(std::meta::data_member_spec(columnType, {.name = std::meta::identifier_of(member)}));
+            }
+            std::meta::define_aggregate(^^type, columns);
+        }
+    };
+}
+
+/**
+ * @brief Struct-of-arrays type generated from T, e.g. for `struct RiverInfo { std::string riverLabel; double length; }`
+ * it has members `Column<std::string> riverLabel;` and `Column<double> length;`.
+ */
+template <typename T>
+using ColumnsFor = typename reflection_impl::ColumnsOf<T>::type;
+
+/**
+ * @brief Result of a columnar parse: one column per member of T, all of length rowCount.
+ */
+template <typename T>
+struct ColumnarResult {
+    ColumnsFor<T> columns;
+    size_t rowCount = 0;
+};
@@ -0,0 +1,407 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <format>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "NetworkClient.hpp"
+#include "RequestScheduler.hpp"
+#include "SPARQReflector.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Spreads queries over several equivalent endpoints (e.g. the public service and local
+ * QLever / Blazegraph mirrors) and routes around slow or failing ones.
+ * - Latency: every successful response updates an EWMA per endpoint and a window of recent
+ *   samples used for its p95.
+ * - Routing: power of two choices. Two random candidates are compared by EWMA latency times
+ *   (1 + requests in flight) and the cheaper one wins, which avoids both herding on the fastest
+ *   endpoint and the cost of scanning all of them.
+ * - Hedging: if the chosen endpoint has not answered after its p95 latency, the query is also
+ *   sent to a second endpoint; the first usable response wins and the other transfer is aborted.
+ * - Failover: a transport error, 429 or 5xx (see RequestScheduler::retryable) moves the query to
+ *   another endpoint. Options::failureThreshold consecutive failures take an endpoint out of
+ *   rotation for Options::cooldown, after which a single request probes it again.
+ * - Health checks: checkHealth() sends Options::healthQuery to every endpoint, optionally on a
+ *   background timer (Options::healthInterval).
+ */
+class EndpointRouter {
+public:
+    struct Options {
+        /// Weight of the newest sample in the latency EWMA.
+        double ewmaAlpha = 0.3;
+        /// Latency samples kept per endpoint for its p95.
+        size_t latencyWindow = 128;
+        /// Send a duplicate request when the first has not answered after the endpoint's p95.
+        bool hedge = true;
+        /// Hedge delay of an endpoint with fewer than minSamples samples.
+        std::chrono::milliseconds initialHedgeDelay{1000};
+        std::chrono::milliseconds minHedgeDelay{20};
+        size_t minSamples = 16;
+        /// Consecutive failures that take an endpoint out of rotation.
+        size_t failureThreshold = 3;
+        /// Time out of rotation before an unhealthy endpoint is probed again.
+        std::chrono::milliseconds cooldown{10'000};
+        /// Period of the background health check; zero disables it.
+        std::chrono::milliseconds healthInterval{0};
+        /// Cheap query sent by health checks.
+        std::string healthQuery = "ASK {}";
+        /// Concurrent transfers: requests, hedges and health checks.
+        size_t maxInFlight = 16;
+    };
+
+    struct Stats {
+        size_t requests = 0;
+        size_t hedges = 0;    ///< Duplicate requests sent
+        size_t hedgeWins = 0; ///< Requests answered by the duplicate
+        size_t failovers = 0; ///< Requests moved to another endpoint after a failure
+    };
+
+    struct EndpointStats {
+        std::string url;
+        bool healthy = true;
+        double latencyMs = 0.0; ///< EWMA; 0 until the first response
+        std::chrono::milliseconds hedgeDelay{0};
+        size_t inFlight = 0;
+        size_t successes = 0;
+        size_t failures = 0;
+    };
+
+    explicit EndpointRouter(std::vector<std::string> urls, Options opts = {})
+        : options(std::move(opts)), workers(options.maxInFlight) {
+        for (std::string& url : urls) addEndpoint(std::move(url));
+        if (options.healthInterval.count() > 0) {
+            healthChecker = std::thread([this] { healthLoop(); });
+        }
+    }
+
+    /// Transfers still running complete before the router is torn down.
+    ~EndpointRouter() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        stopHealth.notify_all();
+        if (healthChecker.joinable()) healthChecker.join();
+    }
+
+    EndpointRouter(const EndpointRouter&) = delete;
+    EndpointRouter& operator=(const EndpointRouter&) = delete;
+
+    /// Registers another endpoint; it starts healthy and unmeasured, so it is tried early.
+    void addEndpoint(std::string url) {
+        std::lock_guard lock(mutex);
+        endpoints.push_back(Endpoint{.url = std::move(url)});
+    }
+
+    /**
+     * @brief Sends @p query to the best endpoint, hedging and failing over as described above.
+     * @return The first usable response (2xx, or a final error such as 400 for a malformed query),
+     * or the last failure once every endpoint was tried.
+     * @throws std::logic_error if no endpoint is registered.
+     */
+    NetworkClient::HttpResponse fetch(const std::string& query, ResultFormat format = ResultFormat::Json) {
+        auto race = std::make_shared<Race>();
+        std::vector<size_t> tried;
+        size_t outstanding = 0;
+
+        auto launch = [&](size_t endpoint) {
+            std::string url;
+            {
+                std::lock_guard lock(mutex);
+                ++endpoints[endpoint].inFlight;
+                url = SparqlReflector::buildQueryUrl(endpoints[endpoint].url, query);
+            }
+            tried.push_back(endpoint);
+            ++outstanding;
+            (void)workers.submit([this, endpoint, url = std::move(url), format, race] {
+                const auto start = Clock::now();
+                NetworkClient client;
+                NetworkClient::HttpResponse response = client.fetch(url, format, &race->cancelled);
+                const bool aborted = response.code == CURLE_ABORTED_BY_CALLBACK && race->cancelled;
+                complete(endpoint, response, Clock::now() - start, aborted);
+                {
+                    std::lock_guard lock(race->mutex);
+                    race->outcomes.push_back(Outcome{endpoint, std::move(response)});
+                }
+                race->done.notify_one();
+            });
+        };
+
+        const size_t primary = choose(tried);
+        if (primary == kNone) throw std::logic_error("EndpointRouter: no endpoints registered");
+        count(&Stats::requests);
+        launch(primary);
+
+        const auto hedgeAt = Clock::now() + hedgeDelay(primary);
+        bool hedged = !options.hedge;
+        size_t hedgeEndpoint = kNone;
+        NetworkClient::HttpResponse last;
+
+        std::unique_lock lock(race->mutex);
+        while (outstanding > 0) {
+            auto arrived = [&] { return !race->outcomes.empty(); };
+            if (!hedged && !race->done.wait_until(lock, hedgeAt, arrived)) {
+                hedged = true;
+                lock.unlock();
+                if (const size_t second = choose(tried); second != kNone) {
+                    count(&Stats::hedges);
+                    hedgeEndpoint = second;
+                    launch(second);
+                }
+                lock.lock();
+                continue;
+            }
+            race->done.wait(lock, arrived);
+
+            Outcome outcome = std::move(race->outcomes.front());
+            race->outcomes.pop_front();
+            --outstanding;
+
+            if (!RequestScheduler::retryable(outcome.response)) {
+                race->cancelled = true;
+                if (outcome.endpoint == hedgeEndpoint) count(&Stats::hedgeWins);
+                return std::move(outcome.response);
+            }
+            last = std::move(outcome.response);
+
+            if (outstanding == 0) {
+                hedged = true; // Failover attempts are not hedged
+                lock.unlock();
+                if (const size_t next = choose(tried); next != kNone) {
+                    count(&Stats::failovers);
+                    launch(next);
+                }
+                lock.lock();
+            }
+        }
+        return last;
+    }
+
+    /**
+     * @brief Runs a SPARQL query through the router and parses the rows into T.
+     * @throws std::runtime_error if no endpoint produced a usable response.
+     */
+    template <typename T>
+    std::vector<T> query(const std::string& sparql, ResultFormat format = ResultFormat::Json) {
+        const NetworkClient::HttpResponse response = fetch(sparql, format);
+        if (!response.ok()) {
+            throw std::runtime_error(response.code != CURLE_OK
+                ? std::format("curl: {}", curl_easy_strerror(response.code))
+                : std::format("HTTP status {}", response.status));
+        }
+        return SparqlReflector::parseResponse<T>(response.body, format);
+    }
+
+    /**
+     * @brief Sends Options::healthQuery to every endpoint concurrently and waits for the answers.
+     * Successes return an endpoint to rotation; failures count towards Options::failureThreshold.
+     * Health checks do not feed the latency statistics, which describe real queries.
+     */
+    void checkHealth() {
+        std::vector<std::future<void>> checks;
+        std::vector<std::string> urls;
+        {
+            std::lock_guard lock(mutex);
+            for (const Endpoint& endpoint : endpoints) {
+                urls.push_back(SparqlReflector::buildQueryUrl(endpoint.url, options.healthQuery));
+            }
+        }
+        for (size_t i = 0; i < urls.size(); ++i) {
+            checks.push_back(workers.submit([this, i, url = std::move(urls[i])] {
+                NetworkClient client;
+                {
+                    std::lock_guard lock(mutex);
+                    ++endpoints[i].inFlight;
+                }
+                complete(i, client.fetch(url), {}, false, false);
+            }));
+        }
+        for (auto& check : checks) check.wait();
+    }
+
+    /**
+     * @brief Delay after which a request to @p endpoint is hedged: its p95 latency over the
+     * recent window, at least Options::minHedgeDelay.
+     */
+    [[nodiscard]] std::chrono::milliseconds hedgeDelay(size_t endpoint) const {
+        std::lock_guard lock(mutex);
+        return hedgeDelayLocked(endpoints[endpoint]);
+    }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard lock(mutex);
+        return statistics;
+    }
+
+    [[nodiscard]] std::vector<EndpointStats> endpointStats() const {
+        std::lock_guard lock(mutex);
+        const auto now = Clock::now();
+        std::vector<EndpointStats> result;
+        for (const Endpoint& endpoint : endpoints) {
+            result.push_back(EndpointStats{endpoint.url, available(endpoint, now), endpoint.latencyMs,
+                                           hedgeDelayLocked(endpoint), endpoint.inFlight, endpoint.successes,
+                                           endpoint.failures});
+        }
+        return result;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    struct Endpoint {
+        std::string url;
+        double latencyMs = 0.0;
+        std::vector<double> samples; ///< Ring buffer of recent latencies in ms
+        size_t nextSample = 0;
+        size_t inFlight = 0;
+        size_t successes = 0;
+        size_t failures = 0;
+        size_t consecutiveFailures = 0;
+        Clock::time_point retryAt{}; ///< When an unhealthy endpoint may be probed again
+    };
+
+    struct Outcome {
+        size_t endpoint;
+        NetworkClient::HttpResponse response;
+    };
+
+    /// Completions of the attempts of one fetch(); shared with the workers running them.
+    struct Race {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::deque<Outcome> outcomes;
+        std::atomic<bool> cancelled{false};
+    };
+
+    // Caller holds mutex
+    bool available(const Endpoint& endpoint, Clock::time_point now) const {
+        return endpoint.consecutiveFailures < options.failureThreshold || now >= endpoint.retryAt;
+    }
+
+    // Power of two choices among available endpoints not tried yet; unavailable ones only as a last resort
+    size_t choose(const std::vector<size_t>& tried) {
+        std::lock_guard lock(mutex);
+        const auto now = Clock::now();
+        std::vector<size_t> candidates;
+        for (bool lastResort : {false, true}) {
+            for (size_t i = 0; i < endpoints.size(); ++i) {
+                if (std::ranges::find(tried, i) == tried.end() && (lastResort || available(endpoints[i], now))) {
+                    candidates.push_back(i);
+                }
+            }
+            if (!candidates.empty()) break;
+        }
+        if (candidates.empty()) return kNone;
+
+        size_t chosen = candidates[0];
+        if (candidates.size() > 1) {
+            std::uniform_int_distribution<size_t> pick(0, candidates.size() - 1);
+            const size_t a = pick(random);
+            size_t b = pick(random);
+            while (b == a) b = pick(random);
+            chosen = cost(endpoints[candidates[a]]) <= cost(endpoints[candidates[b]]) ? candidates[a] : candidates[b];
+        }
+
+        // An endpoint past its cooldown gets one probe per cooldown, not a stampede
+        Endpoint& endpoint = endpoints[chosen];
+        if (endpoint.consecutiveFailures >= options.failureThreshold) endpoint.retryAt = now + options.cooldown;
+        return chosen;
+    }
+
+    static double cost(const Endpoint& endpoint) {
+        return endpoint.latencyMs * static_cast<double>(1 + endpoint.inFlight);
+    }
+
+    /**
+     * @brief Records the outcome of one transfer.
+     * An aborted hedge loser was at least @p elapsed slow; that lower bound still feeds its EWMA,
+     * so an endpoint that keeps losing does not stay unmeasured (and thus preferred).
+     */
+    void complete(size_t index, const NetworkClient::HttpResponse& response, Clock::duration elapsed, bool aborted,
+                  bool measure = true) {
+        std::lock_guard lock(mutex);
+        Endpoint& endpoint = endpoints[index];
+        --endpoint.inFlight;
+        const double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+
+        if (aborted) {
+            if (measure) observe(endpoint, ms);
+            return;
+        }
+        if (RequestScheduler::retryable(response)) {
+            ++endpoint.failures;
+            if (++endpoint.consecutiveFailures >= options.failureThreshold) {
+                endpoint.retryAt = Clock::now() + options.cooldown;
+            }
+            return;
+        }
+        ++endpoint.successes;
+        endpoint.consecutiveFailures = 0;
+        if (!measure) return;
+
+        observe(endpoint, ms);
+        if (endpoint.samples.size() < options.latencyWindow) {
+            endpoint.samples.push_back(ms);
+        } else if (!endpoint.samples.empty()) {
+            endpoint.samples[endpoint.nextSample] = ms;
+            endpoint.nextSample = (endpoint.nextSample + 1) % endpoint.samples.size();
+        }
+    }
+
+    // Caller holds mutex
+    void observe(Endpoint& endpoint, double ms) const {
+        endpoint.latencyMs = endpoint.latencyMs == 0.0 ? ms : options.ewmaAlpha * ms + (1.0 - options.ewmaAlpha) * endpoint.latencyMs;
+    }
+
+    // Caller holds mutex
+    std::chrono::milliseconds hedgeDelayLocked(const Endpoint& endpoint) const {
+        if (endpoint.samples.size() < std::max<size_t>(options.minSamples, 1)) return options.initialHedgeDelay;
+        std::vector<double> sorted = endpoint.samples;
+        const auto rank = sorted.begin() + static_cast<std::ptrdiff_t>(0.95 * static_cast<double>(sorted.size() - 1));
+        std::ranges::nth_element(sorted, rank);
+        return std::max(options.minHedgeDelay, std::chrono::milliseconds(static_cast<long long>(*rank)));
+    }
+
+    void count(size_t Stats::* counter) {
+        std::lock_guard lock(mutex);
+        ++(statistics.*counter);
+    }
+
+    void healthLoop() {
+        std::unique_lock lock(mutex);
+        while (!stopHealth.wait_for(lock, options.healthInterval, [this] { return stopping; })) {
+            lock.unlock();
+            checkHealth();
+            lock.lock();
+        }
+    }
+
+    Options options;
+    mutable std::mutex mutex;
+    std::vector<Endpoint> endpoints;
+    Stats statistics;
+    std::mt19937_64 random{std::random_device{}()};
+    bool stopping = false;
+    std::condition_variable stopHealth;
+    std::thread healthChecker;
+
+    // Declared last so the workers stop before the state their tasks use
+    ThreadPool workers;
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// Dictionary shared by every Interned<> without an explicit tag.
+struct DefaultInternTag;
+
+/**
+ * @brief Dictionary-encoded string: a 4-byte id into a process-wide dictionary per @p Tag.
+ * Declaring a member as Interned<> instead of std::string opts it into dictionary encoding:
+ * the parser interns each value, so a label repeated across millions of rows is stored once
+ * and every row only holds its id. Equality and hashing compare ids.
+ *
+ * Columns with unrelated value sets should use their own tag (Interned<struct CountryTag>)
+ * so their dictionaries stay small. Entries are never removed; intern open-ended values
+ * (descriptions, IRIs of individual items) as plain strings instead.
+ */
+template <typename Tag = DefaultInternTag>
+class Interned {
+public:
+    using Id = uint32_t;
+
+    /// The empty string, which is always id 0.
+    Interned() = default;
+
+    explicit Interned(std::string_view text) : key(intern(text)) {}
+
+    [[nodiscard]] Id id() const { return key; }
+    [[nodiscard]] bool empty() const { return key == 0; }
+
+    /// The interned text; stays valid for the lifetime of the process.
+    [[nodiscard]] std::string_view view() const { return lookup(key); }
+    [[nodiscard]] std::string str() const { return std::string(view()); }
+
+    bool operator==(const Interned&) const = default;
+    bool operator==(std::string_view text) const { return view() == text; }
+
+    /// Number of distinct values in this tag's dictionary, including the empty string.
+    static size_t dictionarySize() {
+        Dictionary& dict = dictionary();
+        std::shared_lock lock(dict.mutex);
+        return dict.texts.size();
+    }
+
+    /**
+     * @brief Returns the id of @p text, adding it to the dictionary if it is new.
+     * Known values only take a shared lock, so parallel parsers rarely wait on each other.
+     * @throws std::length_error if the dictionary would exceed 2^32 entries.
+     */
+    static Id intern(std::string_view text) {
+        if (text.empty()) return 0;
+        Dictionary& dict = dictionary();
+        {
+            std::shared_lock lock(dict.mutex);
+            if (auto it = dict.ids.find(text); it != dict.ids.end()) return it->second;
+        }
+
+        std::unique_lock lock(dict.mutex);
+        if (auto it = dict.ids.find(text); it != dict.ids.end()) return it->second; // Raced with another writer
+        if (dict.texts.size() > std::numeric_limits<Id>::max()) {
+            throw std::length_error("Interned: dictionary is full");
+        }
+        const auto id = static_cast<Id>(dict.texts.size());
+        const std::string& stored = dict.storage.emplace_back(text); // Deque: never moves existing entries
+        dict.texts.push_back(stored);
+        dict.ids.emplace(stored, id);
+        return id;
+    }
+
+private:
+    struct Dictionary {
+        std::shared_mutex mutex;
+        std::deque<std::string> storage;
+        std::vector<std::string_view> texts{ std::string_view() }; ///< Indexed by id; id 0 is ""
+        std::unordered_map<std::string_view, Id> ids;
+    };
+
+    static Dictionary& dictionary() {
+        // Never destroyed: ids may still be printed during static destruction
+        static Dictionary* dict = new Dictionary;
+        return *dict;
+    }
+
+    static std::string_view lookup(Id id) {
+        if (id == 0) return {};
+        Dictionary& dict = dictionary();
+        std::shared_lock lock(dict.mutex);
+        return dict.texts[id];
+    }
+
+    Id key = 0;
+};
+
+template <typename Tag>
+struct std::hash<Interned<Tag>> {
+    size_t operator()(const Interned<Tag>& value) const noexcept { return std::hash<uint32_t>{}(value.id()); }
+};
+
+template <typename Tag>
+struct std::formatter<Interned<Tag>> : std::formatter<std::string_view> {
+    auto format(const Interned<Tag>& value, std::format_context& ctx) const {
+        return std::formatter<std::string_view>::format(value.view(), ctx);
+    }
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+// P2996 Standard Header
+#include <meta>
+
+/**
+ * @brief Why a literal could not be stored in a member.
+ */
+enum class LiteralError {
+    None,
+    Syntax,            ///< Not a valid lexical form for the member type
+    OutOfRange,        ///< Well-formed but does not fit (numeric overflow, text longer than the buffer)
+    UnknownEnumerator, ///< Neither an enumerator name nor an integer
+};
+
+constexpr std::string_view literalErrorName(LiteralError error) {
+    switch (error) {
+        case LiteralError::None:              return "none";
+        case LiteralError::Syntax:            return "syntax";
+        case LiteralError::OutOfRange:        return "out of range";
+        case LiteralError::UnknownEnumerator: return "unknown enumerator";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Converts the lexical form of an RDF literal into a C++ value without allocating or throwing.
+ * Numbers go through std::from_chars on the raw bytes. Supported targets are bool, arithmetic types,
+ * enums (by enumerator name or underlying integer), std::chrono::system_clock time points
+ * (xsd:dateTime / xsd:date), and fixed-size character buffers (char[N], std::array<char, N>).
+ * On failure the target is left untouched and the reason is returned.
+ */
+class LiteralDecoder {
+public:
+    /// True if V is a specialization of the class template @p Template.
+    template <typename V, std::meta::info Template>
+    static consteval bool isSpecializationOf() {
+        return std::meta::has_template_arguments(^^V) && std::meta::template_of(^^V) == Template;
+    }
+
+    template <typename V>
+    static constexpr bool isOptional = isSpecializationOf<V, ^^std::optional>();
+
+    template <typename V>
+    static consteval bool isSystemTimePoint() {
+        if constexpr (isSpecializationOf<V, ^^std::chrono::time_point>()) {
+            return std::is_same_v<typename V::clock, std::chrono::system_clock>;
+        }
+        return false;
+    }
+
+    template <typename V>
+    static consteval bool isCharBuffer() {
+        if constexpr (std::is_array_v<V>) {
+            return std::rank_v<V> == 1 && std::is_same_v<std::remove_extent_t<V>, char>;
+        } else if constexpr (isSpecializationOf<V, ^^std::array>()) {
+            return std::is_same_v<typename V::value_type, char>;
+        }
+        return false;
+    }
+
+    /// Scalar types decode() accepts.
+    template <typename V>
+    static constexpr bool supports = std::is_arithmetic_v<V> || std::is_enum_v<V> ||
+                                     isSystemTimePoint<V>() || isCharBuffer<V>();
+
+    /**
+     * @brief Decodes @p text (already unescaped) into @p out.
+     */
+    template <typename V>
+        requires supports<V>
+    static LiteralError decode(std::string_view text, V& out) {
+        if constexpr (std::is_same_v<V, bool>) {
+            return decodeBool(text, out);
+        } else if constexpr (std::is_arithmetic_v<V>) {
+            return decodeNumber(text, out);
+        } else if constexpr (std::is_enum_v<V>) {
+            return decodeEnum(text, out);
+        } else if constexpr (isSystemTimePoint<V>()) {
+            using Duration = typename V::duration;
+            std::chrono::sys_seconds time;
+            std::chrono::nanoseconds fraction;
+            if (LiteralError error = parseDateTime(text, time, fraction); error != LiteralError::None) return error;
+            out = std::chrono::floor<Duration>(time) + std::chrono::floor<Duration>(fraction);
+            return LiteralError::None;
+        } else {
+            return decodeBuffer(text, out);
+        }
+    }
+
+    /**
+     * @brief Parses xsd:dateTime ("[-]YYYY-MM-DDThh:mm:ss[.fff][Z|(+|-)hh:mm]") or xsd:date
+     * ("[-]YYYY-MM-DD[Z|(+|-)hh:mm]"). Offsets are applied, so the result is UTC.
+     * Times without an offset are taken as UTC. Whole seconds and the fraction are returned
+     * separately so that historical dates do not overflow a nanosecond clock.
+     */
+    static LiteralError parseDateTime(std::string_view text, std::chrono::sys_seconds& out, std::chrono::nanoseconds& fraction) {
+        using namespace std::chrono;
+
+        size_t pos = 0;
+        const bool negativeYear = !text.empty() && text[0] == '-';
+        if (negativeYear) ++pos;
+
+        const size_t yearEnd = text.find('-', pos);
+        if (yearEnd == std::string_view::npos || yearEnd - pos < 4) return LiteralError::Syntax;
+        int yearValue = 0;
+        if (!readNumber(text.substr(pos, yearEnd - pos), yearValue)) return LiteralError::Syntax;
+        if (negativeYear) yearValue = -yearValue;
+        pos = yearEnd + 1;
+
+        int monthValue = 0;
+        int dayValue = 0;
+        if (!readFixed(text, pos, monthValue) || !expect(text, pos, '-') || !readFixed(text, pos, dayValue)) {
+            return LiteralError::Syntax;
+        }
+        if (yearValue < int(year::min()) || yearValue > int(year::max())) return LiteralError::OutOfRange;
+
+        const year_month_day date{year{yearValue}, month{unsigned(monthValue)}, day{unsigned(dayValue)}};
+        if (!date.ok()) return LiteralError::OutOfRange;
+
+        seconds timeOfDay{0};
+        fraction = nanoseconds{0};
+        if (pos < text.size() && text[pos] == 'T') {
+            ++pos;
+            int hours = 0, minutes = 0, seconds = 0;
+            if (!readFixed(text, pos, hours) || !expect(text, pos, ':') ||
+                !readFixed(text, pos, minutes) || !expect(text, pos, ':') || !readFixed(text, pos, seconds)) {
+                return LiteralError::Syntax;
+            }
+            // 24:00:00 is the end of the day; 60 seconds allows a leap second
+            if (hours > 24 || minutes > 59 || seconds > 60 ||
+                (hours == 24 && (minutes != 0 || seconds != 0))) {
+                return LiteralError::OutOfRange;
+            }
+            timeOfDay = std::chrono::hours{hours} + std::chrono::minutes{minutes} + std::chrono::seconds{seconds};
+
+            if (pos < text.size() && text[pos] == '.') {
+                ++pos;
+                const size_t fractionStart = pos;
+                int64_t nanos = 0;
+                int digits = 0;
+                for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+                    if (digits < 9) {
+                        nanos = nanos * 10 + (text[pos] - '0');
+                        ++digits;
+                    }
+                }
+                if (pos == fractionStart) return LiteralError::Syntax;
+                for (; digits < 9; ++digits) nanos *= 10;
+                fraction = nanoseconds{nanos};
+            }
+        }
+
+        // Time zone: "Z", "+hh:mm" or "-hh:mm"
+        minutes offset{0};
+        if (pos < text.size()) {
+            if (text[pos] == 'Z') {
+                ++pos;
+            } else if (text[pos] == '+' || text[pos] == '-') {
+                const int sign = text[pos++] == '-' ? -1 : 1;
+                int offsetHours = 0, offsetMinutes = 0;
+                if (!readFixed(text, pos, offsetHours) || !expect(text, pos, ':') || !readFixed(text, pos, offsetMinutes)) {
+                    return LiteralError::Syntax;
+                }
+                if (offsetHours > 14 || offsetMinutes > 59) return LiteralError::OutOfRange;
+                offset = sign * (std::chrono::hours{offsetHours} + std::chrono::minutes{offsetMinutes});
+            }
+        }
+        if (pos != text.size()) return LiteralError::Syntax;
+
+        out = sys_days{date} + timeOfDay - offset;
+        return LiteralError::None;
+    }
+
+    /// @return The enumerator's name, or an empty view if @p value has none.
+    template <typename E>
+        requires std::is_enum_v<E>
+    static constexpr std::string_view enumName(E value) {
+        for (const auto& [name, enumerator] : enumEntries<E>) {
+            if (enumerator == value) return name;
+        }
+        return {};
+    }
+
+    /// @return The text stored in a character buffer, up to its first NUL.
+    template <typename V>
+        requires (isCharBuffer<V>())
+    static std::string_view bufferText(const V& buffer) {
+        const char* begin = std::data(buffer);
+        const size_t capacity = std::size(buffer);
+        const void* nul = std::memchr(begin, '\0', capacity);
+        return std::string_view(begin, nul ? static_cast<const char*>(nul) - begin : capacity);
+    }
+
+private:
+    // xsd:boolean lexical space
+    static LiteralError decodeBool(std::string_view text, bool& out) {
+        if (text == "true" || text == "1") out = true;
+        else if (text == "false" || text == "0") out = false;
+        else return LiteralError::Syntax;
+        return LiteralError::None;
+    }
+
+    template <typename V>
+    static LiteralError decodeNumber(std::string_view text, V& out) {
+        // XSD allows an explicit plus sign, from_chars does not
+        if (!text.empty() && text[0] == '+') text.remove_prefix(1);
+
+        V value{};
+        const char* end = text.data() + text.size();
+        const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+        if (ec == std::errc::result_out_of_range) return LiteralError::OutOfRange;
+        if (ec != std::errc{} || ptr != end) return LiteralError::Syntax;
+        out = value;
+        return LiteralError::None;
+    }
+
+    template <typename E>
+    static constexpr auto enumEntries = [] consteval {
+        constexpr size_t count = std::meta::enumerators_of(^^E).size();
+        std::array<std::pair<std::string_view, E>, count> entries{};
+        size_t i = 0;
+        for (auto enumerator : std::meta::enumerators_of(^^E)) {
+            entries[i++] = {std::meta::identifier_of(enumerator), std::meta::extract<E>(enumerator)};
+        }
+        return entries;
+    }();
+
+    template <typename E>
+    static LiteralError decodeEnum(std::string_view text, E& out) {
+        for (const auto& [name, enumerator] : enumEntries<E>) {
+            if (name == text) {
+                out = enumerator;
+                return LiteralError::None;
+            }
+        }
+
+        std::underlying_type_t<E> raw{};
+        if (decodeNumber(text, raw) != LiteralError::None) return LiteralError::UnknownEnumerator;
+        out = static_cast<E>(raw);
+        return LiteralError::None;
+    }
+
+    template <typename V>
+    static LiteralError decodeBuffer(std::string_view text, V& out) {
+        // A C array keeps a terminating NUL; std::array<char, N> may be filled completely
+        constexpr size_t capacity = std::is_array_v<V> ? std::extent_v<V> - 1 : std::tuple_size_v<V>;
+        if (text.size() > capacity) return LiteralError::OutOfRange;
+
+        char* dest = std::data(out);
+        std::memcpy(dest, text.data(), text.size());
+        std::memset(dest + text.size(), 0, std::size(out) - text.size());
+        return LiteralError::None;
+    }
+
+    static bool readNumber(std::string_view digits, int& value) {
+        const char* end = digits.data() + digits.size();
+        const auto [ptr, ec] = std::from_chars(digits.data(), end, value);
+        return ec == std::errc{} && ptr == end;
+    }
+
+    // Reads exactly two digits at @p pos
+    static bool readFixed(std::string_view text, size_t& pos, int& value) {
+        if (pos + 2 > text.size()) return false;
+        const char high = text[pos];
+        const char low = text[pos + 1];
+        if (high < '0' || high > '9' || low < '0' || low > '9') return false;
+        value = (high - '0') * 10 + (low - '0');
+        pos += 2;
+        return true;
+    }
+
+    static bool expect(std::string_view text, size_t& pos, char c) {
+        if (pos >= text.size() || text[pos] != c) return false;
+        ++pos;
+        return true;
+    }
+};
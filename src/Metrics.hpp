@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <curl/curl.h>
+
+// Build with -DSPARQ_METRICS=0 (CMake: -DSPARQ_ENABLE_METRICS=OFF) to compile all instrumentation out.
+#ifndef SPARQ_METRICS
+#define SPARQ_METRICS 1
+#endif
+
+/**
+ * @brief Process-wide timers and counters for query execution.
+ * Every thread records into its own slot with plain relaxed stores (no locks, no contended
+ * cache lines); snapshot() sums the live slots plus the totals of threads that have exited.
+ * Phase timings are kept as count / sum / max and a fixed log-scale histogram, and can be
+ * exported as Prometheus text or JSON. With SPARQ_METRICS=0 every recording call and the
+ * timers are empty inline functions, so instrumented code compiles to nothing.
+ */
+class Metrics {
+public:
+    static constexpr bool kEnabled = SPARQ_METRICS != 0;
+
+    enum class Phase {
+        QueryBuild,         ///< Generating the query text
+        UrlEncode,          ///< Percent-encoding the query into the URL
+        Dns,                ///< Name resolution (only for new connections)
+        Connect,            ///< TCP connect (only for new connections)
+        Tls,                ///< TLS handshake (only for new connections)
+        FirstByte,          ///< Request sent until the first response byte (server time)
+        Transfer,           ///< First until last response byte
+        BindingsExtraction, ///< Locating the rows in a response
+        MemberDecode,       ///< Decoding rows into members
+        Materialization,    ///< Allocating and assembling result containers
+        Export,             ///< Writing rows out through BulkExporter
+        Count
+    };
+
+    enum class Counter {
+        Requests,
+        TransportErrors,
+        HttpErrors,
+        BytesReceived,
+        Rows,
+        DecodeFailures,
+        Count
+    };
+
+    static constexpr size_t kPhaseCount = static_cast<size_t>(Phase::Count);
+    static constexpr size_t kCounterCount = static_cast<size_t>(Counter::Count);
+
+    /// Upper bounds of the histogram buckets, in seconds (a final +Inf bucket follows).
+    static constexpr std::array<double, 7> kBucketBounds = { 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1.0, 10.0 };
+    static constexpr size_t kBucketCount = kBucketBounds.size() + 1;
+
+    struct PhaseStats {
+        uint64_t count = 0;
+        uint64_t totalNanos = 0;
+        uint64_t maxNanos = 0;
+        std::array<uint64_t, kBucketCount> buckets{}; ///< Non-cumulative
+    };
+
+    struct Snapshot {
+        std::array<PhaseStats, kPhaseCount> phases{};
+        std::array<uint64_t, kCounterCount> counters{};
+
+        const PhaseStats& operator[](Phase phase) const { return phases[static_cast<size_t>(phase)]; }
+        uint64_t operator[](Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+    };
+
+    static constexpr std::string_view phaseName(Phase phase) {
+        constexpr std::array<std::string_view, kPhaseCount> names = {
+            "query_build", "url_encode", "dns", "connect", "tls", "first_byte", "transfer",
+            "bindings_extraction", "member_decode", "materialization", "export"
+        };
+        return names[static_cast<size_t>(phase)];
+    }
+
+    static constexpr std::string_view counterName(Counter counter) {
+        constexpr std::array<std::string_view, kCounterCount> names = {
+            "requests", "transport_errors", "http_errors", "bytes_received", "rows", "decode_failures"
+        };
+        return names[static_cast<size_t>(counter)];
+    }
+
+    /// Adds one timing sample for @p phase.
+    static void record(Phase phase, std::chrono::nanoseconds elapsed) {
+        if constexpr (kEnabled) {
+            PhaseCells& cells = localSlot().phases[static_cast<size_t>(phase)];
+            const auto nanos = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+            bump(cells.count, 1);
+            bump(cells.totalNanos, nanos);
+            if (nanos > cells.maxNanos.load(std::memory_order_relaxed)) {
+                cells.maxNanos.store(nanos, std::memory_order_relaxed);
+            }
+            bump(cells.buckets[bucketOf(nanos)], 1);
+        }
+    }
+
+    static void add(Counter counter, uint64_t delta = 1) {
+        if constexpr (kEnabled) {
+            bump(localSlot().counters[static_cast<size_t>(counter)], delta);
+        }
+    }
+
+    /**
+     * @brief Records the connection and transfer phases of a finished easy handle.
+     * Phases that did not happen (DNS, connect and TLS on a reused connection) are skipped.
+     */
+    static void recordTransfer(CURL* curl, CURLcode result) {
+        if constexpr (kEnabled) {
+            add(Counter::Requests);
+            if (result != CURLE_OK) add(Counter::TransportErrors);
+
+            long status = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+            if (result == CURLE_OK && (status < 200 || status >= 300)) add(Counter::HttpErrors);
+
+            // All *_TIME_T values are microseconds since the start of the request
+            curl_off_t dns = 0, connect = 0, tls = 0, pretransfer = 0, firstByte = 0, total = 0, bytes = 0;
+            curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+            curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+            curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tls);
+            curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &pretransfer);
+            curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &firstByte);
+            curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+            curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+
+            using std::chrono::microseconds;
+            if (dns > 0) record(Phase::Dns, microseconds(dns));
+            if (connect > dns) record(Phase::Connect, microseconds(connect - dns));
+            if (tls > connect) record(Phase::Tls, microseconds(tls - connect));
+            if (firstByte > 0) record(Phase::FirstByte, microseconds(firstByte - std::min(pretransfer, firstByte)));
+            if (total > 0) record(Phase::Transfer, microseconds(total - std::min(firstByte, total)));
+            if (bytes > 0) add(Counter::BytesReceived, static_cast<uint64_t>(bytes));
+        }
+    }
+
+    /**
+     * @brief Times consecutive phases of one operation: each lap() records the time since the
+     * previous lap (or construction) under the given phase.
+     */
+    class Stopwatch {
+    public:
+        void lap(Phase phase) {
+#if SPARQ_METRICS
+            const auto now = std::chrono::steady_clock::now();
+            record(phase, now - last);
+            last = now;
+#else
+            (void)phase;
+#endif
+        }
+
+    private:
+#if SPARQ_METRICS
+        std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+#endif
+    };
+
+    /// Records the lifetime of the timer under @p phase.
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Phase phase) : phase(phase) {}
+        ~ScopedTimer() { watch.lap(phase); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Phase phase;
+        Stopwatch watch;
+    };
+
+    /// Sums the slots of all threads, live and exited.
+    static Snapshot snapshot() {
+        Snapshot result;
+        if constexpr (kEnabled) {
+            Registry& reg = registry();
+            std::lock_guard lock(reg.mutex);
+            result = reg.retired;
+            for (const Slot* slot : reg.live) accumulate(result, *slot);
+        }
+        return result;
+    }
+
+    /// Clears all totals. Samples recorded concurrently with the reset may be lost.
+    static void reset() {
+        if constexpr (kEnabled) {
+            Registry& reg = registry();
+            std::lock_guard lock(reg.mutex);
+            reg.retired = Snapshot{};
+            for (Slot* slot : reg.live) slot->clear();
+        }
+    }
+
+    /// Prometheus text exposition: one histogram family for the phases, one counter per Counter.
+    static std::string toPrometheus() {
+        const Snapshot totals = snapshot();
+        std::string out;
+        auto it = std::back_inserter(out);
+
+        std::format_to(it, "# HELP sparq_phase_seconds Time spent per query execution phase.\n"
+                            "# TYPE sparq_phase_seconds histogram\n");
+        for (size_t p = 0; p < kPhaseCount; ++p) {
+            const PhaseStats& stats = totals.phases[p];
+            const std::string_view name = phaseName(static_cast<Phase>(p));
+            uint64_t cumulative = 0;
+            for (size_t b = 0; b < kBucketBounds.size(); ++b) {
+                cumulative += stats.buckets[b];
+                std::format_to(it, "sparq_phase_seconds_bucket{{phase=\"{}\",le=\"{}\"}} {}\n", name, kBucketBounds[b], cumulative);
+            }
+            std::format_to(it, "sparq_phase_seconds_bucket{{phase=\"{}\",le=\"+Inf\"}} {}\n", name, stats.count);
+            std::format_to(it, "sparq_phase_seconds_sum{{phase=\"{}\"}} {}\n", name, seconds(stats.totalNanos));
+            std::format_to(it, "sparq_phase_seconds_count{{phase=\"{}\"}} {}\n", name, stats.count);
+        }
+
+        for (size_t c = 0; c < kCounterCount; ++c) {
+            const std::string_view name = counterName(static_cast<Counter>(c));
+            std::format_to(it, "# TYPE sparq_{}_total counter\nsparq_{}_total {}\n", name, name, totals.counters[c]);
+        }
+        return out;
+    }
+
+    /// JSON object with "phases" (count, sum/max seconds) and "counters".
+    static std::string toJson() {
+        const Snapshot totals = snapshot();
+        std::string out = "{\"phases\":{";
+        auto it = std::back_inserter(out);
+
+        for (size_t p = 0; p < kPhaseCount; ++p) {
+            const PhaseStats& stats = totals.phases[p];
+            std::format_to(it, "{}\"{}\":{{\"count\":{},\"sum_seconds\":{},\"max_seconds\":{}}}", p ? "," : "",
+                           phaseName(static_cast<Phase>(p)), stats.count, seconds(stats.totalNanos), seconds(stats.maxNanos));
+        }
+        out += "},\"counters\":{";
+        for (size_t c = 0; c < kCounterCount; ++c) {
+            std::format_to(it, "{}\"{}\":{}", c ? "," : "", counterName(static_cast<Counter>(c)), totals.counters[c]);
+        }
+        out += "}}";
+        return out;
+    }
+
+private:
+    struct PhaseCells {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalNanos{0};
+        std::atomic<uint64_t> maxNanos{0};
+        std::array<std::atomic<uint64_t>, kBucketCount> buckets{};
+    };
+
+    /// One thread's totals. Only the owning thread writes; others read with relaxed loads.
+    struct Slot {
+        std::array<PhaseCells, kPhaseCount> phases{};
+        std::array<std::atomic<uint64_t>, kCounterCount> counters{};
+
+        void clear() {
+            for (PhaseCells& cells : phases) {
+                cells.count.store(0, std::memory_order_relaxed);
+                cells.totalNanos.store(0, std::memory_order_relaxed);
+                cells.maxNanos.store(0, std::memory_order_relaxed);
+                for (auto& bucket : cells.buckets) bucket.store(0, std::memory_order_relaxed);
+            }
+            for (auto& counter : counters) counter.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<Slot*> live;
+        Snapshot retired; ///< Totals of threads that have exited
+    };
+
+    /// Registers the calling thread's slot on first use and folds it into the totals at thread exit.
+    struct SlotHandle {
+        Slot* slot = new Slot;
+
+        SlotHandle() {
+            Registry& reg = registry();
+            std::lock_guard lock(reg.mutex);
+            reg.live.push_back(slot);
+        }
+
+        ~SlotHandle() {
+            Registry& reg = registry();
+            {
+                std::lock_guard lock(reg.mutex);
+                accumulate(reg.retired, *slot);
+                std::erase(reg.live, slot);
+            }
+            delete slot;
+        }
+    };
+
+    static Registry& registry() {
+        // Never destroyed: worker threads may still exit during static destruction
+        static Registry* reg = new Registry;
+        return *reg;
+    }
+
+    static Slot& localSlot() {
+        thread_local SlotHandle handle;
+        return *handle.slot;
+    }
+
+    // Single writer per slot, so a load and a store suffice (no locked read-modify-write)
+    static void bump(std::atomic<uint64_t>& cell, uint64_t delta) {
+        cell.store(cell.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    static size_t bucketOf(uint64_t nanos) {
+        const double secs = seconds(nanos);
+        size_t bucket = 0;
+        while (bucket < kBucketBounds.size() && secs > kBucketBounds[bucket]) ++bucket;
+        return bucket;
+    }
+
+    static double seconds(uint64_t nanos) { return static_cast<double>(nanos) * 1e-9; }
+
+    static void accumulate(Snapshot& totals, const Slot& slot) {
+        for (size_t p = 0; p < kPhaseCount; ++p) {
+            const PhaseCells& cells = slot.phases[p];
+            PhaseStats& stats = totals.phases[p];
+            stats.count += cells.count.load(std::memory_order_relaxed);
+            stats.totalNanos += cells.totalNanos.load(std::memory_order_relaxed);
+            stats.maxNanos = std::max(stats.maxNanos, cells.maxNanos.load(std::memory_order_relaxed));
+            for (size_t b = 0; b < kBucketCount; ++b) {
+                stats.buckets[b] += cells.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+        for (size_t c = 0; c < kCounterCount; ++c) {
+            totals.counters[c] += slot.counters[c].load(std::memory_order_relaxed);
+        }
+    }
+};
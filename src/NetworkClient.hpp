@@ -1,29 +1,55 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <curl/curl.h>
 #include <iostream>
 #include <functional>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <chrono>
 #include <print> // C++23 for cleaner output
 
+#include "Metrics.hpp"
+
+/**
+ * @brief Serialization requested from the SPARQL endpoint.
+ * TSV and CSV carry the same rows as JSON without the per-cell {"type":..,"value":..} wrapper,
+ * typically a third of the size; CSV drops datatypes and language tags.
+ */
+enum class ResultFormat { Json, Tsv, Csv };
+
+/// @return The media type requested for @p format.
+constexpr std::string_view mediaTypeOf(ResultFormat format) {
+    switch (format) {
+        case ResultFormat::Tsv: return "text/tab-separated-values";
+        case ResultFormat::Csv: return "text/csv";
+        default:                return "application/sparql-results+json";
+    }
+}
+
 /**
  * @brief Simple HTTP client wrapper around libcurl.
  * Designed to fetch JSON data from SPARQL endpoints.
+ *
+ * All instances share one process-wide state: the global cURL initialization, a curl_share
+ * object holding the DNS and TLS session caches, and a pool of keep-alive easy handles.
+ * Requests therefore skip repeated DNS lookups and TCP/TLS handshakes, and any instance
+ * may be used concurrently from several threads.
  */
 class NetworkClient {
 public:
     /**
-     * @brief Initialize global CURL environment.
-     * @warning Not thread-safe if multiple clients are created concurrently 
-     * without external global init.
+     * @brief Cheap handle onto the process-wide cURL state (initialized on first use).
      */
     NetworkClient() {
-        curl_global_init(CURL_GLOBAL_DEFAULT);
+        (void)state();
     }
 
-    ~NetworkClient() {
-        curl_global_cleanup();
-    }
+    /// Upper bound on idle easy handles kept for reuse.
+    static constexpr size_t kMaxIdleHandles = 16;
 
     /**
      * @brief Callback function for cURL to write received data into a string.
@@ -40,46 +66,87 @@ public:
         return totalSize;
     }
 
+    /**
+     * @brief Handler invoked for every chunk of the response body as libcurl delivers it.
+     * Return false to abort the transfer.
+     */
+    using ChunkHandler = std::function<bool(std::string_view)>;
+
+    /**
+     * @brief Callback function for cURL to forward received data to a ChunkHandler.
+     * @param userp User pointer (ChunkHandler*).
+     * @return size_t Total bytes handled, or 0 to make cURL abort the transfer.
+     */
+    static size_t StreamCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        size_t totalSize = size * nmemb;
+        auto* handler = static_cast<ChunkHandler*>(userp);
+        return (*handler)(std::string_view(static_cast<char*>(contents), totalSize)) ? totalSize : 0;
+    }
+
+    /**
+     * @brief Outcome of a request: transport result, HTTP status and body.
+     */
+    struct HttpResponse {
+        CURLcode code = CURLE_OK;
+        long status = 0;
+        std::string body;
+        /// Delay requested by a Retry-After header (typically with 429 or 503); zero if absent.
+        std::chrono::seconds retryAfter{0};
+
+        /// True for a completed transfer with a 2xx status.
+        [[nodiscard]] bool ok() const { return code == CURLE_OK && status >= 200 && status < 300; }
+    };
+
+    /**
+     * @brief Executes a GET request and reports the transport result and HTTP status with the body.
+     * Unlike performGet, error responses are distinguishable from successful ones.
+     * @param url The target SPARQL endpoint URL (already encoded with query).
+     * @param format Result serialization to request.
+     * @param cancelled Optional flag; once set, the transfer is aborted with CURLE_ABORTED_BY_CALLBACK.
+     */
+    [[nodiscard]]
+    HttpResponse fetch(const std::string& url, ResultFormat format = ResultFormat::Json,
+                       const std::atomic<bool>* cancelled = nullptr) {
+        HttpResponse response;
+        response.code = perform(url, WriteCallback, &response.body, &response.status, format, &response.retryAfter, cancelled);
+        return response;
+    }
+
     /**
      * @brief Executes a GET request to the specified URL.
      * * @param url The target SPARQL endpoint URL (already encoded with query).
+     * @param format Result serialization to request.
      * @return std::string The raw response body.
      */
     [[nodiscard]] 
-    std::string performGet(const std::string& url) {
-        CURL* curl = curl_easy_init();
+    std::string performGet(const std::string& url, ResultFormat format = ResultFormat::Json) {
         std::string readBuffer;
 
-        if (!curl) {
-            std::println(stderr, "Error: Failed to initialize CURL.");
-            return "";
+        CURLcode res = perform(url, WriteCallback, &readBuffer, nullptr, format);
+        if (res != CURLE_OK) {
+            std::println(stderr, "curl_easy_perform() failed: {}", curl_easy_strerror(res));
         }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        
-        // Set User-Agent to avoid being blocked by Wikidata/DBpedia
-        curl_easy_setopt(curl, CURLOPT_USERAGENT, "SparqReflect/0.1.0");
-
-        // Setup write callback
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+        return readBuffer;
+    }
 
-        // Accept JSON
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Accept: application/sparql-results+json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    /**
+     * @brief Executes a GET request and hands the body to @p onChunk piece by piece.
+     * Nothing is accumulated here, so memory use is bounded by what the handler keeps.
+     * @param url The target SPARQL endpoint URL (already encoded with query).
+     * @param onChunk Receives each chunk; returning false stops the transfer early.
+     * @param format Result serialization to request.
+     * @return true if the transfer completed or was stopped by the handler.
+     */
+    bool performGetStreaming(const std::string& url, ChunkHandler onChunk, ResultFormat format = ResultFormat::Json) {
+        CURLcode res = perform(url, StreamCallback, &onChunk, nullptr, format);
 
-        // Perform request
-        CURLcode res = curl_easy_perform(curl);
-        
-        if (res != CURLE_OK) {
+        // CURLE_WRITE_ERROR is what cURL reports when the handler asked to stop.
+        if (res != CURLE_OK && res != CURLE_WRITE_ERROR) {
             std::println(stderr, "curl_easy_perform() failed: {}", curl_easy_strerror(res));
+            return false;
         }
-
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-        
-        return readBuffer;
+        return true;
     }
     
     /**
@@ -88,18 +155,183 @@ public:
      * @return std::string URL-encoded string.
      */
     [[nodiscard]]
-    std::string urlEncode(const std::string& value) {
-        CURL* curl = curl_easy_init();
-        if (curl) {
-            char* output = curl_easy_escape(curl, value.c_str(), static_cast<int>(value.length()));
-            if (output) {
-                std::string result(output);
-                curl_free(output);
-                curl_easy_cleanup(curl);
-                return result;
+    static std::string urlEncode(const std::string& value) {
+        Metrics::ScopedTimer timer(Metrics::Phase::UrlEncode);
+
+        // Since cURL 7.82 the handle argument is unused, so no easy handle is needed
+        char* output = curl_easy_escape(nullptr, value.c_str(), static_cast<int>(value.length()));
+        if (!output) return "";
+
+        std::string result(output);
+        curl_free(output);
+        return result;
+    }
+
+    /**
+     * @brief Takes a keep-alive easy handle from the pool (or creates one).
+     * The handle is attached to the shared DNS/TLS caches; return it with releaseHandle().
+     * @return CURL* A ready handle, or nullptr if cURL could not create one.
+     */
+    CURL* acquireHandle() {
+        SharedState& shared = state();
+        CURL* curl = nullptr;
+        {
+            std::lock_guard lock(shared.poolMutex);
+            if (!shared.idleHandles.empty()) {
+                curl = shared.idleHandles.back();
+                shared.idleHandles.pop_back();
             }
-            curl_easy_cleanup(curl);
         }
-        return "";
+        if (!curl) curl = curl_easy_init();
+        if (!curl) return nullptr;
+
+        curl_easy_setopt(curl, CURLOPT_SHARE, shared.share);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L); // Required for use from worker threads
+        return curl;
+    }
+
+    /**
+     * @brief Returns a handle to the pool. Its options are reset, but its open
+     * connections stay alive for the next request.
+     */
+    void releaseHandle(CURL* curl) {
+        if (!curl) return;
+        curl_easy_reset(curl);
+
+        SharedState& shared = state();
+        {
+            std::lock_guard lock(shared.poolMutex);
+            if (shared.idleHandles.size() < kMaxIdleHandles) {
+                shared.idleHandles.push_back(curl);
+                return;
+            }
+        }
+        curl_easy_cleanup(curl);
+    }
+
+    /**
+     * @brief Applies the options of a SPARQL GET request to an easy handle from acquireHandle().
+     * Used directly by callers that drive handles themselves (e.g. through curl_multi).
+     * @param url The target URL; must stay alive until the transfer completes.
+     * @param callback cURL write callback receiving the body.
+     * @param userData Destination passed to @p callback.
+     * @param format Result serialization to request (sets the Accept header).
+     */
+    void configureGet(CURL* curl, const std::string& url, size_t (*callback)(void*, size_t, size_t, void*), void* userData,
+                      ResultFormat format = ResultFormat::Json) {
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        
+        // Set User-Agent to avoid being blocked by Wikidata/DBpedia
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, "SparqReflect/0.1.0");
+
+        // Setup write callback
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, callback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, userData);
+
+        // Offer every encoding this libcurl was built with (gzip, br, ...); the body is decoded transparently
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+
+        // Accept header per format (the header lists are shared and read-only, so they outlive every transfer)
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, state().acceptHeaders[static_cast<size_t>(format)]);
+    }
+
+private:
+    /**
+     * @brief Process-wide cURL resources, created on first use and torn down at exit.
+     */
+    struct SharedState {
+        CURLSH* share = nullptr;
+        std::array<std::mutex, CURL_LOCK_DATA_LAST> shareLocks;
+        std::mutex poolMutex;
+        std::vector<CURL*> idleHandles;
+        std::array<curl_slist*, 3> acceptHeaders{}; ///< Indexed by ResultFormat
+
+        SharedState() {
+            curl_global_init(CURL_GLOBAL_DEFAULT);
+            for (ResultFormat format : {ResultFormat::Json, ResultFormat::Tsv, ResultFormat::Csv}) {
+                const std::string header = "Accept: " + std::string(mediaTypeOf(format));
+                acceptHeaders[static_cast<size_t>(format)] = curl_slist_append(nullptr, header.c_str());
+            }
+
+            // Connection caches are deliberately not shared: libcurl does not support using a
+            // shared connection cache from concurrent threads. Pooled handles keep their own
+            // keep-alive connections instead.
+            share = curl_share_init();
+            curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+            curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+            curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        }
+
+        ~SharedState() {
+            for (CURL* curl : idleHandles) curl_easy_cleanup(curl);
+            curl_share_cleanup(share);
+            for (curl_slist* headers : acceptHeaders) curl_slist_free_all(headers);
+            curl_global_cleanup();
+        }
+
+        SharedState(const SharedState&) = delete;
+        SharedState& operator=(const SharedState&) = delete;
+    };
+
+    static SharedState& state() {
+        static SharedState shared;
+        return shared;
+    }
+
+    static void lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userp) {
+        static_cast<SharedState*>(userp)->shareLocks[data].lock();
+    }
+
+    static void unlockShare(CURL*, curl_lock_data data, void* userp) {
+        static_cast<SharedState*>(userp)->shareLocks[data].unlock();
+    }
+
+    // Progress callback: a non-zero return aborts the transfer, also while waiting for the first byte
+    static int cancelCallback(void* userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+        return static_cast<const std::atomic<bool>*>(userp)->load(std::memory_order_relaxed) ? 1 : 0;
+    }
+
+    /**
+     * @brief Shared request setup for the buffered and streaming GET variants.
+     * @param callback cURL write callback receiving the body.
+     * @param userData Destination passed to @p callback.
+     * @param status Optional out-parameter receiving the HTTP status code.
+     * @param format Result serialization to request.
+     * @param retryAfter Optional out-parameter receiving the Retry-After delay.
+     * @param cancelled Optional flag that aborts the transfer once set.
+     */
+    CURLcode perform(const std::string& url, size_t (*callback)(void*, size_t, size_t, void*), void* userData,
+                     long* status = nullptr, ResultFormat format = ResultFormat::Json,
+                     std::chrono::seconds* retryAfter = nullptr, const std::atomic<bool>* cancelled = nullptr) {
+        CURL* curl = acquireHandle();
+
+        if (!curl) {
+            std::println(stderr, "Error: Failed to initialize CURL.");
+            return CURLE_FAILED_INIT;
+        }
+
+        configureGet(curl, url, callback, userData, format);
+        if (cancelled) {
+            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+            curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancelCallback);
+            curl_easy_setopt(curl, CURLOPT_XFERINFODATA, const_cast<std::atomic<bool>*>(cancelled));
+        }
+
+        // Perform request
+        CURLcode res = curl_easy_perform(curl);
+        if (status) curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, status);
+        if (retryAfter) {
+            curl_off_t seconds = 0; // Parsed by libcurl from either delay-seconds or an HTTP date
+            curl_easy_getinfo(curl, CURLINFO_RETRY_AFTER, &seconds);
+            *retryAfter = std::chrono::seconds(seconds);
+        }
+        Metrics::recordTransfer(curl, res);
+
+        releaseHandle(curl);
+        
+        return res;
     }
 };
\ No newline at end of file
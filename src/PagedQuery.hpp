@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <format>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "NetworkClient.hpp"
+#include "SPARQReflector.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Input range over the rows of a query fetched page by page with LIMIT/OFFSET.
+ * While the caller consumes one page, the next Options::prefetch pages are already being
+ * fetched and parsed in the background, so the network and the consumer overlap.
+ * The page size adapts to the endpoint: it grows while pages come back well under
+ * Options::targetLatency and shrinks when they are slow. A page that fails with a timeout,
+ * a 429 or a 5xx is split in half and retried.
+ *
+ * The query must not contain LIMIT/OFFSET itself and should have an ORDER BY, otherwise
+ * the endpoint is free to return overlapping pages.
+ * @code
+ * PagedQuery<RiverInfo> rivers(query);
+ * for (const RiverInfo& river : rivers) { ... }
+ * @endcode
+ */
+template <typename T>
+class PagedQuery {
+public:
+    struct Options {
+        std::string endpoint = std::string(SparqlReflector::kDefaultEndpoint);
+        ResultFormat format = ResultFormat::Json;
+        /// Rows per page for the first request.
+        size_t pageSize = 1000;
+        size_t minPageSize = 50;
+        size_t maxPageSize = 20000;
+        /// Pages requested ahead of the one being consumed.
+        size_t prefetch = 2;
+        /// Pages faster than half of this grow the page size, slower ones shrink it.
+        std::chrono::milliseconds targetLatency{2000};
+        /// Attempts per row range before the error is thrown to the consumer.
+        size_t maxRetries = 3;
+        /// Wait before a retry, multiplied by the attempt number. A 429 with Retry-After waits
+        /// as long as the endpoint asked instead.
+        std::chrono::milliseconds retryDelay{500};
+        /// Stop after this many rows; 0 means until the result is exhausted.
+        size_t maxRows = 0;
+    };
+
+    struct Stats {
+        size_t pages = 0;
+        size_t rows = 0;
+        size_t retries = 0;
+        size_t pageSize = 0; ///< Current page size
+    };
+
+    /**
+     * @param query A complete SELECT query without LIMIT/OFFSET.
+     */
+    explicit PagedQuery(std::string query, Options opts = {})
+        : baseQuery(std::move(query)), options(std::move(opts)),
+          pageSize(std::clamp(options.pageSize, options.minPageSize, options.maxPageSize)),
+          workers(options.prefetch + 1) {}
+
+    /**
+     * @brief Pages a query whose SELECT clause is generated from T (see buildSimpleQuery).
+     */
+    static PagedQuery simple(std::string_view whereClause, Options opts = {}) {
+        return PagedQuery(std::format("{} WHERE {}", SparqlReflector::selectClause<T>(), whereClause), std::move(opts));
+    }
+
+    /// Stops fetching: pending retries stop waiting and transfers already on the wire are aborted.
+    ~PagedQuery() {
+        {
+            std::lock_guard lock(cancelMutex);
+            cancelled = true;
+        }
+        cancelSignal.notify_all();
+    }
+
+    PagedQuery(const PagedQuery&) = delete;
+    PagedQuery& operator=(const PagedQuery&) = delete;
+
+    class iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::input_iterator_tag;
+
+        iterator() = default;
+
+        T& operator*() const { return owner->current[index]; }
+        T* operator->() const { return &owner->current[index]; }
+
+        /// Moves to the next row, waiting for the next page at a page boundary.
+        /// Throws std::runtime_error once a page has failed Options::maxRetries times.
+        iterator& operator++() {
+            if (++index >= owner->current.size()) {
+                owner->advance();
+                index = 0;
+            }
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return index >= owner->current.size(); }
+
+    private:
+        friend class PagedQuery;
+        explicit iterator(PagedQuery* owner) : owner(owner) {}
+
+        PagedQuery* owner = nullptr;
+        size_t index = 0;
+    };
+
+    /// Starts fetching and waits for the first page. The range can be iterated once.
+    iterator begin() {
+        advance();
+        return iterator(this);
+    }
+
+    std::default_sentinel_t end() const { return {}; }
+
+    [[nodiscard]] Stats stats() const {
+        Stats result = statistics;
+        result.pageSize = pageSize;
+        return result;
+    }
+
+private:
+    struct PageResult {
+        CURLcode code = CURLE_OK;
+        long status = 0;
+        std::chrono::steady_clock::duration latency{};
+        std::chrono::seconds retryAfter{0};
+        std::vector<T> rows;
+    };
+
+    struct Page {
+        size_t offset = 0;
+        size_t size = 0;
+        size_t attempt = 0;
+        std::future<PageResult> result;
+    };
+
+    // Keeps prefetch + 1 pages in flight while the result may continue
+    void fill() {
+        while (!exhausted && inFlight.size() <= options.prefetch) {
+            size_t size = pageSize;
+            if (options.maxRows) {
+                if (nextOffset >= options.maxRows) return;
+                size = std::min(size, options.maxRows - nextOffset);
+            }
+            inFlight.push_back(issue(nextOffset, size, 0, {}));
+            nextOffset += size;
+        }
+    }
+
+    // Requests one page on a worker after waiting @p delay (backoff for retries)
+    Page issue(size_t offset, size_t size, size_t attempt, std::chrono::milliseconds delay) {
+        Page page{ .offset = offset, .size = size, .attempt = attempt };
+        std::string url = SparqlReflector::buildQueryUrl(
+            options.endpoint, std::format("{} LIMIT {} OFFSET {}", baseQuery, size, offset));
+
+        page.result = workers.submit([this, url = std::move(url), delay] {
+            PageResult result;
+            {
+                // Woken early by the destructor
+                std::unique_lock lock(cancelMutex);
+                cancelSignal.wait_for(lock, delay, [this] { return cancelled.load(); });
+            }
+            if (cancelled) {
+                result.code = CURLE_ABORTED_BY_CALLBACK;
+                return result;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            NetworkClient client;
+            NetworkClient::HttpResponse response = client.fetch(url, options.format, &cancelled);
+            result.latency = std::chrono::steady_clock::now() - start;
+            result.code = response.code;
+            result.status = response.status;
+            result.retryAfter = response.retryAfter;
+            if (response.ok()) result.rows = SparqlReflector::parseResponse<T>(response.body, options.format);
+            return result;
+        });
+        return page;
+    }
+
+    // Replaces the current page with the next successful one (left empty at the end)
+    void advance() {
+        current.clear();
+        while (true) {
+            fill();
+            if (inFlight.empty()) return;
+
+            Page page = std::move(inFlight.front());
+            inFlight.pop_front();
+            PageResult result = page.result.get();
+
+            if (result.code != CURLE_OK || result.status < 200 || result.status >= 300) {
+                retry(page, result);
+                continue;
+            }
+
+            const bool full = result.rows.size() == page.size;
+            adapt(result.latency, full);
+            if (!full) {
+                // Short page: the result ends here, later pages can only be empty
+                exhausted = true;
+                inFlight.clear();
+            }
+
+            ++statistics.pages;
+            statistics.rows += result.rows.size();
+            current = std::move(result.rows);
+            if (!current.empty()) return;
+        }
+    }
+
+    // Splits a failed range into smaller pages and requests them ahead of everything else
+    void retry(const Page& page, const PageResult& result) {
+        const bool retryable = result.code != CURLE_OK || result.status == 429 || result.status >= 500;
+        if (!retryable || page.attempt + 1 >= options.maxRetries) {
+            const std::string reason = result.code != CURLE_OK
+                ? std::format("curl: {}", curl_easy_strerror(result.code))
+                : std::format("HTTP status {}", result.status);
+            throw std::runtime_error(std::format("page at offset {} failed: {}", page.offset, reason));
+        }
+
+        ++statistics.retries;
+        pageSize = std::max(options.minPageSize, page.size / 2);
+
+        const size_t attempt = page.attempt + 1;
+        const std::chrono::milliseconds delay = result.status == 429 && result.retryAfter.count() > 0
+            ? std::chrono::milliseconds(result.retryAfter)
+            : options.retryDelay * attempt;
+
+        std::vector<Page> pieces;
+        for (size_t offset = page.offset; offset < page.offset + page.size; offset += pageSize) {
+            pieces.push_back(issue(offset, std::min(pageSize, page.offset + page.size - offset), attempt, delay));
+        }
+        for (auto it = pieces.rbegin(); it != pieces.rend(); ++it) {
+            inFlight.push_front(std::move(*it));
+        }
+    }
+
+    void adapt(std::chrono::steady_clock::duration latency, bool fullPage) {
+        if (latency > options.targetLatency) {
+            pageSize = std::max(options.minPageSize, pageSize / 2);
+        } else if (fullPage && latency < options.targetLatency / 2) {
+            pageSize = std::min(options.maxPageSize, pageSize * 2);
+        }
+    }
+
+    std::string baseQuery;
+    Options options;
+    size_t pageSize;
+    size_t nextOffset = 0;
+    bool exhausted = false;
+    std::deque<Page> inFlight;
+    std::vector<T> current;
+    Stats statistics;
+    std::atomic<bool> cancelled = false;
+    std::mutex cancelMutex;
+    std::condition_variable cancelSignal;
+
+    // Declared last so the workers stop before the state their tasks read
+    ThreadPool workers;
+};
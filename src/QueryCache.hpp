@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "NetworkClient.hpp"
+#include "SPARQReflector.hpp"
+
+namespace reflection_impl {
+    /// Spelling of T's type, e.g. "River", so structs with identical members still get distinct keys.
+    template <typename T>
+    constexpr std::string cacheTypeText() {
+        return std::string(meta::display_string_of(^^T));
+    }
+}
+
+/**
+ * @brief Two-tier cache for query results.
+ * Entries are keyed by the normalized query text, the endpoint and the name and layout
+ * fingerprint of the reflected result type.
+ * - Memory tier: LRU of parsed std::vector<T> results, bounded by approximate bytes. A hit skips
+ *   both the network and the JSON parse.
+ * - Disk tier (optional): one file per response body in a cache directory, read back through
+ *   mmap. A hit skips the network and is shared between processes and runs, but it stores the
+ *   raw JSON, so the rows are parsed again (and then kept in the memory tier). Use
+ *   BinarySnapshot<T> to persist parsed rows instead.
+ * Both tiers honor a TTL; the disk tier evicts the least recently written files above its size limit.
+ */
+class QueryCache {
+public:
+    using Clock = std::chrono::system_clock;
+
+    struct Options {
+        /// Budget of the memory tier, measured in response-body bytes.
+        size_t memoryBytes = size_t{64} << 20;
+        /// Directory of the disk tier; empty disables it.
+        std::filesystem::path directory;
+        /// Budget of the disk tier.
+        std::uintmax_t diskBytes = std::uintmax_t{1} << 30;
+        /// Lifetime of new entries in both tiers.
+        std::chrono::seconds ttl{3600};
+    };
+
+    struct Stats {
+        size_t memoryHits = 0;
+        size_t diskHits = 0;
+        size_t misses = 0;
+    };
+
+    /**
+     * @brief A cached response body mapped read-only into memory.
+     */
+    class MappedBody {
+    public:
+        MappedBody(void* mapping, size_t mappingSize, size_t bodyOffset, size_t bodySize)
+            : mapping(mapping), mappingSize(mappingSize), bodyOffset(bodyOffset), bodySize(bodySize) {}
+
+        MappedBody(MappedBody&& other) noexcept
+            : mapping(std::exchange(other.mapping, nullptr)), mappingSize(other.mappingSize),
+              bodyOffset(other.bodyOffset), bodySize(other.bodySize) {}
+
+        MappedBody& operator=(MappedBody&&) = delete;
+        MappedBody(const MappedBody&) = delete;
+
+        ~MappedBody() {
+            if (mapping) munmap(mapping, mappingSize);
+        }
+
+        [[nodiscard]] std::string_view body() const {
+            return std::string_view(static_cast<const char*>(mapping) + bodyOffset, bodySize);
+        }
+
+    private:
+        void* mapping;
+        size_t mappingSize;
+        size_t bodyOffset;
+        size_t bodySize;
+    };
+
+    QueryCache() : QueryCache(Options{}) {}
+
+    explicit QueryCache(Options opts) : options(std::move(opts)) {
+        if (!options.directory.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(options.directory, ec);
+        }
+    }
+
+    /**
+     * @brief Canonical form of a query for use in cache keys.
+     * Comments are dropped and whitespace runs collapse to one space, except inside string
+     * literals and IRIs, which are kept verbatim.
+     */
+    static std::string normalizeQuery(std::string_view query) {
+        std::string result;
+        result.reserve(query.size());
+        bool pendingSpace = false;
+
+        auto emit = [&](std::string_view text) {
+            if (pendingSpace && !result.empty()) result.push_back(' ');
+            pendingSpace = false;
+            result.append(text);
+        };
+
+        for (size_t pos = 0; pos < query.size();) {
+            char c = query[pos];
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                pendingSpace = true;
+                ++pos;
+            } else if (c == '#') {
+                // Comment: skip to the end of the line
+                size_t end = query.find('\n', pos);
+                pos = end == std::string_view::npos ? query.size() : end;
+                pendingSpace = true;
+            } else if (c == '"' || c == '\'') {
+                // String literal, honoring backslash escapes
+                size_t end = pos + 1;
+                while (end < query.size() && query[end] != c) end += query[end] == '\\' ? 2 : 1;
+                end = std::min(end + 1, query.size());
+                emit(query.substr(pos, end - pos));
+                pos = end;
+            } else if (c == '<') {
+                // IRI if it closes before any whitespace, otherwise a comparison operator
+                size_t end = query.find_first_of("> \t\n\r", pos + 1);
+                if (end != std::string_view::npos && query[end] == '>') {
+                    emit(query.substr(pos, end + 1 - pos));
+                    pos = end + 1;
+                } else {
+                    emit(query.substr(pos, 1));
+                    ++pos;
+                }
+            } else {
+                emit(query.substr(pos, 1));
+                ++pos;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Cache key of a query whose rows are parsed into T.
+     */
+    template <typename T>
+    static std::string makeKey(std::string_view endpoint, std::string_view query) {
+        return std::format("{:016x}|{}|{}|{}", SparqlReflector::layoutFingerprint<T>(),
+                           reflection_impl::StaticText<reflection_impl::cacheTypeText<T>>::view(),
+                           endpoint, normalizeQuery(query));
+    }
+
+    /**
+     * @brief Runs a query through the cache: memory tier, then disk tier, then the network.
+     * Only successful (2xx) responses are stored.
+     * @return Shared, immutable rows; nullptr if the request failed.
+     */
+    template <typename T>
+    std::shared_ptr<const std::vector<T>> fetch(NetworkClient& client, std::string_view endpoint, const std::string& query) {
+        const std::string key = makeKey<T>(endpoint, query);
+
+        if (auto cached = lookupMemory<std::vector<T>>(key)) {
+            ++memoryHits;
+            return cached;
+        }
+
+        if (auto mapped = lookupDisk(key)) {
+            ++diskHits;
+            auto rows = std::make_shared<const std::vector<T>>(SparqlReflector::parseJsonResponse<T>(mapped->body()));
+            storeMemory(key, rows, mapped->body().size());
+            return rows;
+        }
+
+        ++misses;
+        NetworkClient::HttpResponse response = client.fetch(SparqlReflector::buildQueryUrl(endpoint, query));
+        if (!response.ok()) return nullptr;
+
+        auto rows = std::make_shared<const std::vector<T>>(SparqlReflector::parseJsonResponse<T>(response.body));
+        storeDisk(key, response.body);
+        storeMemory(key, rows, response.body.size());
+        return rows;
+    }
+
+    /// @return The unexpired memory-tier value for @p key, or nullptr (also if it was stored as another type).
+    template <typename V>
+    std::shared_ptr<const V> lookupMemory(const std::string& key) {
+        std::lock_guard lock(memoryMutex);
+        auto it = memoryIndex.find(key);
+        if (it == memoryIndex.end()) return nullptr;
+
+        if (it->second->expiresAt <= Clock::now()) {
+            eraseMemory(it->second);
+            return nullptr;
+        }
+        if (*it->second->type != typeid(V)) return nullptr;
+        lru.splice(lru.begin(), lru, it->second); // Most recently used first
+        return std::static_pointer_cast<const V>(it->second->value);
+    }
+
+    /**
+     * @brief Stores a parsed value, evicting least recently used entries beyond the byte budget.
+     * @param cost Approximate size of the value (the response body size is a good proxy).
+     */
+    template <typename V>
+    void storeMemory(const std::string& key, std::shared_ptr<const V> value, size_t cost) {
+        if (cost > options.memoryBytes) return;
+
+        std::lock_guard lock(memoryMutex);
+        if (auto it = memoryIndex.find(key); it != memoryIndex.end()) eraseMemory(it->second);
+
+        lru.push_front(MemoryEntry{key, std::move(value), &typeid(V), cost, Clock::now() + options.ttl});
+        memoryIndex.emplace(lru.front().key, lru.begin());
+        memoryUsed += cost;
+
+        while (memoryUsed > options.memoryBytes) eraseMemory(std::prev(lru.end()));
+    }
+
+    /// @return The unexpired disk-tier body for @p key, mapped into memory.
+    std::optional<MappedBody> lookupDisk(const std::string& key) {
+        if (options.directory.empty()) return std::nullopt;
+        const std::filesystem::path path = pathFor(key);
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return std::nullopt;
+
+        struct stat info {};
+        void* mapping = MAP_FAILED;
+        if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(DiskHeader)) {
+            mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd); // The mapping stays valid on its own
+        if (mapping == MAP_FAILED) return std::nullopt;
+
+        const size_t fileSize = static_cast<size_t>(info.st_size);
+        DiskHeader header;
+        std::memcpy(&header, mapping, sizeof(header));
+
+        const bool valid = std::memcmp(header.magic, kMagic, sizeof(header.magic)) == 0 &&
+                           header.version == kVersion &&
+                           sizeof(DiskHeader) + header.keyLength + header.bodyLength == fileSize &&
+                           std::string_view(static_cast<const char*>(mapping) + sizeof(DiskHeader), header.keyLength) == key;
+        const bool expired = header.expiresAt <= toUnixSeconds(Clock::now());
+
+        if (!valid || expired) {
+            ::munmap(mapping, fileSize);
+            if (expired) {
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+            return std::nullopt;
+        }
+        return MappedBody(mapping, fileSize, sizeof(DiskHeader) + header.keyLength, header.bodyLength);
+    }
+
+    /**
+     * @brief Writes a response body to the disk tier (atomically, via rename) and enforces its size limit.
+     */
+    void storeDisk(const std::string& key, std::string_view body) {
+        if (options.directory.empty()) return;
+
+        DiskHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.keyLength = static_cast<std::uint32_t>(key.size());
+        header.expiresAt = toUnixSeconds(Clock::now() + options.ttl);
+        header.bodyLength = body.size();
+
+        const std::filesystem::path path = pathFor(key);
+        const std::filesystem::path temp = tempPathFor(path);
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(key.data(), static_cast<std::streamsize>(key.size()));
+            out.write(body.data(), static_cast<std::streamsize>(body.size()));
+            if (!out) {
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(temp, ec);
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec) {
+            std::filesystem::remove(temp, ec);
+            return;
+        }
+        enforceDiskLimit();
+    }
+
+    /// Drops every entry of the memory tier and, if enabled, the disk tier.
+    void clear() {
+        {
+            std::lock_guard lock(memoryMutex);
+            memoryIndex.clear();
+            lru.clear();
+            memoryUsed = 0;
+        }
+        if (!options.directory.empty()) {
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator(options.directory, ec)) {
+                if (entry.path().extension() == kExtension) std::filesystem::remove(entry.path(), ec);
+            }
+        }
+    }
+
+    [[nodiscard]] Stats stats() const {
+        return Stats{memoryHits.load(), diskHits.load(), misses.load()};
+    }
+
+private:
+    static constexpr char kMagic[8] = {'S', 'P', 'Q', 'C', 'A', 'C', 'H', 'E'};
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::string_view kExtension = ".spq";
+
+    /// On-disk entry layout: header, key bytes, body bytes.
+    struct DiskHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t keyLength;
+        std::int64_t expiresAt; ///< Unix seconds
+        std::uint64_t bodyLength;
+    };
+
+    struct MemoryEntry {
+        std::string key;
+        std::shared_ptr<const void> value;
+        const std::type_info* type; ///< Checked on lookup before the value is cast back
+        size_t cost;
+        Clock::time_point expiresAt;
+    };
+
+    using LruList = std::list<MemoryEntry>;
+
+    // Caller holds memoryMutex
+    void eraseMemory(LruList::iterator entry) {
+        memoryUsed -= entry->cost;
+        memoryIndex.erase(entry->key);
+        lru.erase(entry);
+    }
+
+    static std::int64_t toUnixSeconds(Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    }
+
+    std::filesystem::path pathFor(const std::string& key) const {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (char c : key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return options.directory / std::format("{:016x}{}", hash, kExtension);
+    }
+
+    // Unique per process and write, so concurrent writers never share a temp file
+    static std::filesystem::path tempPathFor(const std::filesystem::path& path) {
+        static std::atomic<std::uint64_t> counter{0};
+        std::filesystem::path temp = path;
+        temp += std::format(".{}.{}.tmp", ::getpid(), counter.fetch_add(1, std::memory_order_relaxed));
+        return temp;
+    }
+
+    /// Removes the least recently written entries until the directory fits its budget.
+    void enforceDiskLimit() {
+        struct FileInfo {
+            std::filesystem::path path;
+            std::filesystem::file_time_type written;
+            std::uintmax_t size;
+        };
+
+        std::error_code ec;
+        std::vector<FileInfo> files;
+        std::uintmax_t total = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(options.directory, ec)) {
+            if (entry.path().extension() != kExtension) continue;
+            FileInfo info{entry.path(), entry.last_write_time(ec), entry.file_size(ec)};
+            if (ec) continue;
+            total += info.size;
+            files.push_back(std::move(info));
+        }
+        if (total <= options.diskBytes) return;
+
+        std::sort(files.begin(), files.end(), [](const FileInfo& a, const FileInfo& b) { return a.written < b.written; });
+        for (const auto& file : files) {
+            if (total <= options.diskBytes) break;
+            if (std::filesystem::remove(file.path, ec)) total -= file.size;
+        }
+    }
+
+    Options options;
+
+    std::mutex memoryMutex;
+    LruList lru;
+    std::unordered_map<std::string_view, LruList::iterator> memoryIndex;
+    size_t memoryUsed = 0;
+
+    std::atomic<size_t> memoryHits{0};
+    std::atomic<size_t> diskHits{0};
+    std::atomic<size_t> misses{0};
+};
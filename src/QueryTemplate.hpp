@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "Metrics.hpp"
+#include "SPARQReflector.hpp"
+
+/**
+ * @brief String literal usable as a template argument, e.g. QueryTemplate<T, "{ ... }">.
+ */
+template <size_t N>
+struct FixedString {
+    char chars[N]{};
+
+    consteval FixedString(const char (&text)[N]) { std::copy_n(text, N, chars); }
+
+    constexpr std::string_view view() const { return std::string_view(chars, N - 1); }
+};
+
+/**
+ * @brief Typed parameter of a QueryTemplate, written into the WHERE text as its token.
+ */
+enum class Placeholder {
+    Id,   ///< {id}   Local name such as Q42 or P31, written as is (e.g. after "wd:")
+    Lang, ///< {lang} Language tag such as en or pt-BR
+    Int,  ///< {int}  Integer, e.g. a LIMIT
+    Str,  ///< {str}  Text written as a quoted, escaped string literal
+    Iri   ///< {iri}  Absolute IRI written as <...>
+};
+
+/**
+ * @brief Placeholder scanning and percent-encoding shared by the compile-time template
+ * layout and the runtime binding of values.
+ * Encoding matches curl_easy_escape: everything but ALPHA / DIGIT / "-._~" becomes %XX.
+ */
+class QueryText {
+public:
+    static constexpr bool isUnreserved(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '-' || c == '.' || c == '_' || c == '~';
+    }
+
+    static constexpr void appendEncoded(std::string& out, char c) {
+        constexpr std::string_view hex = "0123456789ABCDEF";
+        if (isUnreserved(c)) {
+            out += c;
+            return;
+        }
+        const auto byte = static_cast<unsigned char>(c);
+        out += '%';
+        out += hex[byte >> 4];
+        out += hex[byte & 0xF];
+    }
+
+    /**
+     * @brief Recognizes a placeholder token at @p pos.
+     * @return Length of the token, or 0 if none starts there.
+     */
+    static constexpr size_t placeholderAt(std::string_view text, size_t pos, Placeholder& kind) {
+        constexpr std::array<std::pair<std::string_view, Placeholder>, 5> tokens = {{
+            { "{id}", Placeholder::Id }, { "{lang}", Placeholder::Lang }, { "{int}", Placeholder::Int },
+            { "{str}", Placeholder::Str }, { "{iri}", Placeholder::Iri },
+        }};
+        if (text[pos] != '{') return 0;
+        for (const auto& [token, tokenKind] : tokens) {
+            if (text.substr(pos, token.size()) == token) {
+                kind = tokenKind;
+                return token.size();
+            }
+        }
+        return 0;
+    }
+
+    static constexpr size_t countPlaceholders(std::string_view text) {
+        size_t count = 0;
+        Placeholder kind{};
+        for (size_t pos = 0; pos < text.size(); ++pos) {
+            if (placeholderAt(text, pos, kind)) ++count;
+        }
+        return count;
+    }
+
+    /// The text with its placeholders removed, percent-encoded.
+    static constexpr std::string encodeStatic(std::string_view text) {
+        std::string out;
+        Placeholder kind{};
+        for (size_t pos = 0; pos < text.size();) {
+            if (const size_t length = placeholderAt(text, pos, kind)) {
+                pos += length;
+            } else {
+                appendEncoded(out, text[pos++]);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Placeholder kinds and where each static segment ends in the encodeStatic() text.
+     * Segment i runs from segmentEnds[i - 1] (0 for the first) to segmentEnds[i]; placeholder i
+     * follows segment i.
+     */
+    template <size_t Count>
+    struct Layout {
+        std::array<Placeholder, Count> kinds{};
+        std::array<size_t, Count + 1> segmentEnds{};
+    };
+
+    template <size_t Count>
+    static constexpr Layout<Count> layout(std::string_view text) {
+        Layout<Count> result;
+        size_t encodedSize = 0;
+        size_t index = 0;
+        Placeholder kind{};
+        for (size_t pos = 0; pos < text.size();) {
+            if (const size_t length = placeholderAt(text, pos, kind)) {
+                result.segmentEnds[index] = encodedSize;
+                result.kinds[index++] = kind;
+                pos += length;
+            } else {
+                encodedSize += isUnreserved(text[pos++]) ? 1 : 3;
+            }
+        }
+        result.segmentEnds[Count] = encodedSize;
+        return result;
+    }
+
+    /**
+     * @brief Validates a text value for @p kind and appends its SPARQL form, percent-encoded.
+     * @throws std::invalid_argument if the value could change the structure of the query.
+     */
+    static void appendTerm(std::string& out, Placeholder kind, std::string_view value) {
+        switch (kind) {
+            case Placeholder::Id:
+                if (value.empty() || !std::ranges::all_of(value, [](char c) { return isAlnum(c) || c == '_' || c == '-'; })) {
+                    throw std::invalid_argument(std::format("invalid {{id}} value: '{}'", value));
+                }
+                out += value; // Unreserved characters only
+                return;
+
+            case Placeholder::Lang:
+                if (value.empty() || !isAlpha(value.front()) || value.back() == '-' ||
+                    !std::ranges::all_of(value, [](char c) { return isAlnum(c) || c == '-'; })) {
+                    throw std::invalid_argument(std::format("invalid {{lang}} value: '{}'", value));
+                }
+                out += value;
+                return;
+
+            case Placeholder::Str:
+                out += "%22";
+                for (char c : value) {
+                    switch (c) {
+                        case '"':  out += "%5C%22"; break;
+                        case '\\': out += "%5C%5C"; break;
+                        case '\n': out += "%5Cn"; break;
+                        case '\r': out += "%5Cr"; break;
+                        case '\t': out += "%5Ct"; break;
+                        default:   appendEncoded(out, c);
+                    }
+                }
+                out += "%22";
+                return;
+
+            case Placeholder::Iri:
+                // IRIREF excludes controls, space and <>"{}|^`\ (SPARQL 1.1, production 139)
+                if (value.empty() || std::ranges::any_of(value, [](char c) {
+                        return static_cast<unsigned char>(c) <= 0x20 || std::string_view("<>\"{}|^`\\").contains(c);
+                    })) {
+                    throw std::invalid_argument(std::format("invalid {{iri}} value: '{}'", value));
+                }
+                out += "%3C";
+                for (char c : value) appendEncoded(out, c);
+                out += "%3E";
+                return;
+
+            case Placeholder::Int:
+                break;
+        }
+        throw std::invalid_argument("{int} placeholders take an integer");
+    }
+
+private:
+    static constexpr bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    static constexpr bool isAlnum(char c) { return isAlpha(c) || (c >= '0' && c <= '9'); }
+};
+
+namespace reflection_impl {
+    /// Select clause of T followed by " WHERE " and the template text.
+    template <typename T, FixedString Where>
+    constexpr std::string templateText() {
+        std::string text = selectText<T>();
+        text += " WHERE ";
+        text += Where.view();
+        return text;
+    }
+
+    template <typename T, FixedString Where>
+    constexpr std::string encodedTemplateText() {
+        return QueryText::encodeStatic(templateText<T, Where>());
+    }
+}
+
+/**
+ * @brief A SELECT query whose text is assembled and percent-encoded at compile time, with
+ * typed placeholders bound at runtime.
+ * The SELECT clause comes from the members of T; @p Where is the rest of the query and may
+ * contain {id}, {lang}, {int}, {str} and {iri} (see Placeholder). Both are stored in the
+ * binary already URL-encoded, so url() only copies the static segments and encodes the
+ * bound values into a buffer that is reused across calls: no reflection, formatting or
+ * curl_easy_escape per query, and no allocation once the buffer has grown.
+ *
+ * Values are validated for their placeholder kind, so a bound value cannot change the
+ * structure of the query. An instance is not thread-safe; use one per thread.
+ * @code
+ * QueryTemplate<Label, R"({ wd:{id} rdfs:label ?label. FILTER(LANG(?label) = "{lang}") } LIMIT {int})"> lookup;
+ * client.fetch(lookup.url("Q42", "en", 1));
+ * @endcode
+ */
+template <typename T, FixedString Where>
+class QueryTemplate {
+    using Text = reflection_impl::StaticText<reflection_impl::templateText<T, Where>>;
+    using Encoded = reflection_impl::StaticText<reflection_impl::encodedTemplateText<T, Where>>;
+
+public:
+    static constexpr size_t kPlaceholderCount = QueryText::countPlaceholders(Where.view());
+    static constexpr QueryText::Layout<kPlaceholderCount> kLayout = QueryText::layout<kPlaceholderCount>(Text::view());
+
+    /// The query with its placeholder tokens, e.g. for logging.
+    static constexpr std::string_view text() { return Text::view(); }
+
+    explicit QueryTemplate(std::string_view endpoint = SparqlReflector::kDefaultEndpoint)
+        : buffer(std::format("{}?query=", endpoint)), prefixLength(buffer.size()) {
+        buffer.reserve(prefixLength + Encoded::size + 64 * kPlaceholderCount);
+    }
+
+    /**
+     * @brief Binds one value per placeholder, in order, and returns the request URL.
+     * {int} takes an integer; the other kinds take anything convertible to std::string_view.
+     * @return The URL, valid until the next call on this instance.
+     * @throws std::invalid_argument if a value is not valid for its placeholder.
+     */
+    template <typename... Args>
+    const std::string& url(const Args&... args) {
+        static_assert(sizeof...(Args) == kPlaceholderCount, "QueryTemplate::url takes one value per placeholder");
+        Metrics::ScopedTimer timer(Metrics::Phase::QueryBuild);
+
+        buffer.resize(prefixLength);
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((appendSegment(I), bind<kLayout.kinds[I]>(args)), ...);
+        }(std::index_sequence_for<Args...>{});
+        appendSegment(kPlaceholderCount);
+        return buffer;
+    }
+
+private:
+    void appendSegment(size_t index) {
+        const size_t begin = index ? kLayout.segmentEnds[index - 1] : 0;
+        buffer.append(Encoded::view().substr(begin, kLayout.segmentEnds[index] - begin));
+    }
+
+    template <Placeholder Kind, typename V>
+    void bind(const V& value) {
+        if constexpr (Kind == Placeholder::Int) {
+            static_assert(std::is_integral_v<V> && !std::is_same_v<V, bool>, "{int} placeholders take an integer");
+            char digits[24];
+            const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            buffer.append(digits, end); // Digits and '-' need no encoding
+        } else {
+            static_assert(std::is_convertible_v<const V&, std::string_view>,
+                          "{id}, {lang}, {str} and {iri} placeholders take text");
+            QueryText::appendTerm(buffer, Kind, std::string_view(value));
+        }
+    }
+
+    std::string buffer;
+    size_t prefixLength;
+};
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <format>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "NetworkClient.hpp"
+#include "SPARQReflector.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Sends requests to one endpoint within its rate limits, instead of bursting into 429s.
+ * Three limits gate every dispatch:
+ * - a token bucket of requests (Options::requestsPerSecond, bursts up to Options::burst);
+ * - a token bucket of query time: each response's latency is charged against
+ *   Options::queryTimePerMinute, the way Wikidata accounts processing time per client;
+ * - at most Options::maxInFlight concurrent requests.
+ * A 429 or 503 carrying Retry-After pauses all dispatching for that long. Other transient
+ * failures (transport errors, 429/5xx without the header) are retried with full-jitter
+ * exponential backoff. Queued requests are served by priority lane, highest first, and
+ * identical concurrent requests (same URL and format) share one transfer and its response.
+ */
+class RequestScheduler {
+public:
+    enum class Priority { High, Normal, Low };
+
+    struct Options {
+        size_t maxInFlight = 5;
+        double requestsPerSecond = 5.0;
+        /// Requests that may be sent back to back after an idle period (the bucket starts this full).
+        /// The bucket holds at least one token, so values below 1 only delay the first request.
+        double burst = 10.0;
+        /// Server-side processing time allowed per minute (Wikidata: 60 s per 60 s).
+        std::chrono::milliseconds queryTimePerMinute{60'000};
+        /// Attempts per request, including the first.
+        size_t maxAttempts = 5;
+        std::chrono::milliseconds baseBackoff{500};
+        std::chrono::milliseconds maxBackoff{30'000};
+    };
+
+    struct Stats {
+        size_t sent = 0;      ///< Transfers performed, retries included
+        size_t coalesced = 0; ///< Callers served by another caller's transfer
+        size_t retries = 0;
+        size_t throttled = 0; ///< 429 responses received
+    };
+
+    /// @throws std::invalid_argument if requestsPerSecond or queryTimePerMinute is not positive.
+    explicit RequestScheduler(Options opts = {})
+        : options(validated(std::move(opts))), requestTokens(std::max(options.burst, 0.0)),
+          queryTimeTokens(static_cast<double>(options.queryTimePerMinute.count())),
+          lastRefill(Clock::now()), workers(options.maxInFlight) {
+        dispatcher = std::thread([this] { dispatch(); });
+    }
+
+    /// Requests still queued are completed with CURLE_ABORTED_BY_CALLBACK; running ones finish.
+    ~RequestScheduler() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        dispatcher.join();
+    }
+
+    RequestScheduler(const RequestScheduler&) = delete;
+    RequestScheduler& operator=(const RequestScheduler&) = delete;
+
+    /**
+     * @brief Queues a GET of @p url, or joins the identical request already queued or running.
+     * Joining with a higher priority moves a still-queued request up to that lane.
+     * @return The final response: the first non-retryable one, or the last attempt's.
+     */
+    std::shared_future<NetworkClient::HttpResponse> fetch(const std::string& url, Priority priority = Priority::Normal,
+                                                          ResultFormat format = ResultFormat::Json) {
+        std::string key = std::format("{}|{}", static_cast<int>(format), url);
+        std::unique_lock lock(mutex);
+
+        if (auto it = pending.find(key); it != pending.end()) {
+            const std::shared_ptr<Job>& job = it->second;
+            ++statistics.coalesced;
+            if (!job->running && priority < job->priority) {
+                job->priority = priority; // The entry left in the old lane is skipped when reached
+                lanes[static_cast<size_t>(priority)].push_back(job);
+                wake.notify_all();
+            }
+            return job->response;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->url = url;
+        job->key = key;
+        job->format = format;
+        job->priority = priority;
+        job->response = job->promise.get_future().share();
+        pending.emplace(std::move(key), job);
+        lanes[static_cast<size_t>(priority)].push_back(job);
+        wake.notify_all();
+        return job->response;
+    }
+
+    /**
+     * @brief Runs a SPARQL query through the scheduler and parses the rows into T.
+     * @throws std::runtime_error if the request ultimately failed.
+     */
+    template <typename T>
+    std::vector<T> query(std::string_view endpoint, const std::string& sparql, Priority priority = Priority::Normal,
+                         ResultFormat format = ResultFormat::Json) {
+        const auto result = fetch(SparqlReflector::buildQueryUrl(endpoint, sparql), priority, format);
+        const NetworkClient::HttpResponse& response = result.get();
+        if (!response.ok()) {
+            throw std::runtime_error(response.code != CURLE_OK
+                ? std::format("curl: {}", curl_easy_strerror(response.code))
+                : std::format("HTTP status {}", response.status));
+        }
+        return SparqlReflector::parseResponse<T>(response.body, format);
+    }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard lock(mutex);
+        return statistics;
+    }
+
+    /**
+     * @brief Delay before retry number @p attempt (1-based): uniform in [0, min(max, base * 2^(attempt-1))].
+     * Full jitter keeps clients that failed together from retrying together.
+     */
+    template <typename Random>
+    static std::chrono::milliseconds backoff(const Options& options, size_t attempt, Random& random) {
+        const auto ceiling = std::min<int64_t>(options.maxBackoff.count(),
+                                               options.baseBackoff.count() << std::min<size_t>(attempt - 1, 20));
+        return std::chrono::milliseconds(std::uniform_int_distribution<int64_t>(0, std::max<int64_t>(ceiling, 0))(random));
+    }
+
+    /// Transport errors and 429 / 500 / 502 / 503 / 504 are worth retrying; other statuses are final.
+    static bool retryable(const NetworkClient::HttpResponse& response) {
+        if (response.code != CURLE_OK) {
+            return response.code != CURLE_URL_MALFORMAT && response.code != CURLE_UNSUPPORTED_PROTOCOL;
+        }
+        return response.status == 429 || response.status == 500 || response.status == 502 ||
+               response.status == 503 || response.status == 504;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        std::string url;
+        std::string key;
+        ResultFormat format = ResultFormat::Json;
+        Priority priority = Priority::Normal;
+        size_t attempt = 0;
+        bool running = false;
+        Clock::time_point notBefore{};
+        std::promise<NetworkClient::HttpResponse> promise;
+        std::shared_future<NetworkClient::HttpResponse> response;
+    };
+
+    // Dispatcher thread: starts the next eligible job whenever every limit allows it
+    void dispatch() {
+        std::unique_lock lock(mutex);
+        while (!stopping) {
+            const auto now = Clock::now();
+            refill(now);
+
+            auto wakeAt = Clock::time_point::max();
+            std::shared_ptr<Job> job;
+            if (inFlight < options.maxInFlight) {
+                if (now < pausedUntil) {
+                    wakeAt = pausedUntil;
+                } else if (requestTokens < 1.0) {
+                    wakeAt = now + secondsToDuration((1.0 - requestTokens) / options.requestsPerSecond);
+                } else if (queryTimeTokens < 0.0) {
+                    wakeAt = now + secondsToDuration(-queryTimeTokens / queryTimeRefillPerSecond());
+                } else {
+                    job = nextReady(now, wakeAt);
+                }
+            }
+
+            if (!job) {
+                if (wakeAt == Clock::time_point::max()) wake.wait(lock);
+                else wake.wait_until(lock, wakeAt);
+                continue;
+            }
+
+            requestTokens -= 1.0;
+            ++inFlight;
+            job->running = true;
+            (void)workers.submit([this, job] { run(job); });
+        }
+
+        // Fail whatever is still queued; running jobs complete through run()
+        for (auto& lane : lanes) {
+            for (const std::shared_ptr<Job>& job : lane) {
+                if (job->running || pending.erase(job->key) == 0) continue;
+                NetworkClient::HttpResponse aborted;
+                aborted.code = CURLE_ABORTED_BY_CALLBACK;
+                job->promise.set_value(std::move(aborted));
+            }
+            lane.clear();
+        }
+    }
+
+    // Highest-priority queued job whose backoff has elapsed; otherwise lowers wakeAt to the earliest one
+    std::shared_ptr<Job> nextReady(Clock::time_point now, Clock::time_point& wakeAt) {
+        for (size_t lane = 0; lane < lanes.size(); ++lane) {
+            auto& queue = lanes[lane];
+            for (auto it = queue.begin(); it != queue.end();) {
+                std::shared_ptr<Job> job = *it;
+                if (job->running || static_cast<size_t>(job->priority) != lane || !pending.contains(job->key)) {
+                    it = queue.erase(it); // Started, moved to another lane, or completed
+                    continue;
+                }
+                if (job->notBefore <= now) {
+                    queue.erase(it);
+                    return job;
+                }
+                wakeAt = std::min(wakeAt, job->notBefore);
+                ++it;
+            }
+        }
+        return nullptr;
+    }
+
+    // Worker thread: one attempt, then either complete the job or queue it for a retry
+    void run(const std::shared_ptr<Job>& job) {
+        const auto start = Clock::now();
+        NetworkClient client;
+        NetworkClient::HttpResponse response = client.fetch(job->url, job->format);
+        const auto finished = Clock::now();
+
+        std::unique_lock lock(mutex);
+        --inFlight;
+        ++statistics.sent;
+        queryTimeTokens -= std::chrono::duration<double, std::milli>(finished - start).count();
+        if (response.status == 429) ++statistics.throttled;
+
+        if (response.retryAfter.count() > 0 && (response.status == 429 || response.status == 503)) {
+            pausedUntil = std::max(pausedUntil, finished + response.retryAfter);
+        }
+
+        if (retryable(response) && job->attempt + 1 < options.maxAttempts && !stopping) {
+            ++job->attempt;
+            ++statistics.retries;
+            job->running = false;
+            job->notBefore = std::max(finished + backoff(options, job->attempt, random), pausedUntil);
+            lanes[static_cast<size_t>(job->priority)].push_back(job);
+        } else {
+            pending.erase(job->key);
+            lock.unlock();
+            job->promise.set_value(std::move(response));
+            lock.lock();
+        }
+        wake.notify_all();
+    }
+
+    void refill(Clock::time_point now) {
+        const double seconds = std::chrono::duration<double>(now - lastRefill).count();
+        lastRefill = now;
+        requestTokens = std::min(bucketCapacity(), requestTokens + seconds * options.requestsPerSecond);
+        queryTimeTokens = std::min(static_cast<double>(options.queryTimePerMinute.count()),
+                                   queryTimeTokens + seconds * queryTimeRefillPerSecond());
+    }
+
+    // A bucket smaller than one token could never pay for a request
+    double bucketCapacity() const {
+        return std::max(options.burst, 1.0);
+    }
+
+    // Both refill rates are divisors of the dispatcher's wait times
+    static Options validated(Options options) {
+        if (!(options.requestsPerSecond > 0.0)) {
+            throw std::invalid_argument("RequestScheduler: requestsPerSecond must be positive");
+        }
+        if (options.queryTimePerMinute.count() <= 0) {
+            throw std::invalid_argument("RequestScheduler: queryTimePerMinute must be positive");
+        }
+        return options;
+    }
+
+    double queryTimeRefillPerSecond() const {
+        return static_cast<double>(options.queryTimePerMinute.count()) / 60.0;
+    }
+
+    static Clock::duration secondsToDuration(double seconds) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    Options options;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::array<std::deque<std::shared_ptr<Job>>, 3> lanes; ///< Indexed by Priority
+    std::unordered_map<std::string, std::shared_ptr<Job>> pending; ///< Queued or running, by URL and format
+    Stats statistics;
+    size_t inFlight = 0;
+    bool stopping = false;
+    double requestTokens;
+    double queryTimeTokens; ///< Milliseconds; negative after an expensive response
+    Clock::time_point lastRefill;
+    Clock::time_point pausedUntil{};
+    std::mt19937_64 random{std::random_device{}()};
+    std::thread dispatcher;
+
+    // Declared last so the workers stop before the state their tasks use
+    ThreadPool workers;
+};
@@ -2,12 +2,27 @@
 
 #include <string>
 #include <vector>
-#include <sstream>
 #include <format>
 #include <string_view>
 #include <utility>
 #include <iostream>
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <concepts>
+#include <future>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
 #include <type_traits> // Required for std::is_integral_v, etc.
 #include <print>       // C++23: Modern printing
 
@@ -15,6 +30,12 @@
 #include <meta> 
 
 #include "NetworkClient.hpp"
+#include "StructuralScanner.hpp"
+#include "ColumnarResult.hpp"
+#include "Interned.hpp"
+#include "LiteralDecoder.hpp"
+#include "Metrics.hpp"
+#include "ThreadPool.hpp"
 
 namespace meta = std::meta;
 
@@ -44,89 +65,1092 @@ public:
      * @return std::vector<std::string> List of JSON substrings, each representing one row item.
      */
     static std::vector<std::string> extractBindings(std::string_view json) {
-        std::vector<std::string> bindings;
-        
-        // 1. Find "results"
-        size_t resultsPos = json.find("\"results\"");
-        if (resultsPos == std::string_view::npos) return bindings;
-
-        // 2. Find "bindings" inside results
-        size_t bindingsPos = json.find("\"bindings\"", resultsPos);
-        if (bindingsPos == std::string_view::npos) return bindings;
-
-        // 3. Find the start of the array '['
-        size_t arrayStart = json.find('[', bindingsPos);
-        if (arrayStart == std::string_view::npos) return bindings;
-
-        // 4. Iterate through array elements (objects enclosed in { })
-        size_t currentPos = arrayStart + 1;
-        int braceCount = 0;
-        size_t itemStart = std::string_view::npos;
-
-        while (currentPos < json.length()) {
-            char c = json[currentPos];
-            if (c == '{') {
-                if (braceCount == 0) itemStart = currentPos;
-                braceCount++;
-            } else if (c == '}') {
-                braceCount--;
-                if (braceCount == 0 && itemStart != std::string_view::npos) {
-                    // Found a complete object { ... }
-                    bindings.emplace_back(json.substr(itemStart, currentPos - itemStart + 1));
-                    itemStart = std::string_view::npos;
+        auto views = extractBindingViews(json);
+        return std::vector<std::string>(views.begin(), views.end());
+    }
+
+    /**
+     * @brief Zero-copy variant of extractBindings.
+     * @param json Full JSON string; must outlive the returned views.
+     * @return std::vector<std::string_view> Views into @p json, one per row object.
+     */
+    static std::vector<std::string_view> extractBindingViews(std::string_view json) {
+        std::vector<std::string_view> bindings;
+        forEachBindingRow(json, [&](std::string_view row) { bindings.push_back(row); });
+        return bindings;
+    }
+
+    /**
+     * @brief extractBindingViews with the view list allocated from @p resource.
+     */
+    static std::pmr::vector<std::string_view> extractBindingViews(std::string_view json, std::pmr::memory_resource* resource) {
+        std::pmr::vector<std::string_view> bindings(resource);
+        forEachBindingRow(json, [&](std::string_view row) { bindings.push_back(row); });
+        return bindings;
+    }
+
+    /**
+     * @brief Reports every row object of the "bindings" array, in order.
+     * @param onRow Called as onRow(std::string_view rowJson) with a view into @p json.
+     */
+    template <typename F>
+    static void forEachBindingRow(std::string_view json, F&& onRow) {
+        constexpr auto npos = std::string_view::npos;
+        size_t openQuote = npos;     // Opening quote of the string being read
+        size_t itemStart = npos;     // Opening brace of the current row
+        bool bindingsKey = false;    // Last token was the string "bindings"
+        bool colonSeen = false;      // ... followed by ':'
+        bool inArray = false;
+        int depth = 0;
+
+        // Walk the structural index: string interiors never show up here,
+        // so braces and brackets inside literals cannot unbalance the count.
+        StructuralScanner::scan(json, [&](size_t pos, char c) {
+            if (!inArray) {
+                // 1. Find the `"bindings": [` token sequence
+                if (c == '"') {
+                    if (openQuote == npos) {
+                        openQuote = pos;
+                    } else {
+                        bindingsKey = json.substr(openQuote + 1, pos - openQuote - 1) == "bindings";
+                        colonSeen = false;
+                        openQuote = npos;
+                    }
+                } else if (c == ':' && bindingsKey) {
+                    colonSeen = true;
+                } else if (c == '[' && colonSeen) {
+                    inArray = true;
+                } else {
+                    bindingsKey = colonSeen = false;
                 }
-            } else if (c == ']' && braceCount == 0) {
-                break; // End of bindings array
+                return true;
             }
-            currentPos++;
-        }
-        return bindings;
+
+            // 2. Iterate through array elements (objects enclosed in { })
+            if (c == '{' || c == '[') {
+                if (depth == 0) itemStart = pos;
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) return false; // End of bindings array
+                if (--depth == 0 && c == '}') {
+                    onRow(json.substr(itemStart, pos - itemStart + 1));
+                }
+            }
+            return true;
+        });
     }
 
     /**
      * @brief Extracts the "value" of a specific variable from a binding JSON string.
      * Looks for: "varName": { ... "value": "TARGET_VALUE" ... }
-     * Robust to whitespace.
+     * Robust to whitespace, escaped quotes and braces inside literals.
      * @param rowJson The JSON string for a single row.
      * @param varName The variable name to search for (e.g., "itemLabel").
      * @return std::string The extracted value or empty string if not found.
      */
     static std::string extractValue(std::string_view rowJson, std::string_view varName) {
-        // Construct search key like "varName"
-        std::string key = "\"" + std::string(varName) + "\"";
-        
-        size_t keyPos = rowJson.find(key);
-        if (keyPos == std::string_view::npos) return "";
+        std::string result;
+        forEachBinding(rowJson, [&](std::string_view name, const StringToken& value) {
+            if (name == varName) assignString(result, value);
+        });
+        return result;
+    }
+
+    /**
+     * @brief A JSON string token: the raw bytes between the quotes.
+     * @c escaped is set when the bytes contain backslash escapes that still need decoding.
+     */
+    struct StringToken {
+        std::string_view text;
+        bool escaped = false;
+    };
+
+    /**
+     * @brief Reads the JSON string starting at the opening quote @p quotePos.
+     * @param token Receives the string contents.
+     * @return size_t Position just past the closing quote, or npos if the string is unterminated.
+     */
+    static size_t scanString(std::string_view json, size_t quotePos, StringToken& token) {
+        size_t pos = quotePos + 1;
+        while (true) {
+            // memchr-speed search; a quote preceded by an odd run of backslashes is escaped
+            pos = json.find('"', pos);
+            if (pos == std::string_view::npos) return pos;
+
+            size_t backslashes = 0;
+            while (pos - backslashes > quotePos + 1 && json[pos - backslashes - 1] == '\\') ++backslashes;
+            if (backslashes % 2 == 0) break;
+            ++pos;
+        }
+        token.text = json.substr(quotePos + 1, pos - quotePos - 1);
+        token.escaped = token.text.find('\\') != std::string_view::npos;
+        return pos + 1;
+    }
+
+    /**
+     * @brief Walks a binding object exactly once, reporting the "value" of every variable.
+     * Expects the SPARQL JSON shape: { "var": { "type": ..., "value": "..." }, ... }.
+     * Quoted strings are skipped as a whole, so braces inside literals are harmless. The row is
+     * scanned with memchr-style searches, not the structural index (which only splits rows).
+     * @param rowJson The JSON object for a single row.
+     * @param onValue Called as onValue(std::string_view varName, const StringToken& value).
+     */
+    template <typename F>
+    static void forEachBinding(std::string_view rowJson, F&& onValue) {
+        constexpr auto npos = std::string_view::npos;
+        size_t pos = rowJson.find('{');
+        if (pos == npos) return;
+        ++pos;
+
+        StringToken name, key, value;
+        while (true) {
+            // Variable name, or the end of the row
+            pos = rowJson.find_first_of("\"}", pos);
+            if (pos == npos || rowJson[pos] == '}') return;
+            if ((pos = scanString(rowJson, pos, name)) == npos) return;
+
+            // The RDF term object describing the variable's binding
+            pos = rowJson.find('{', pos);
+            if (pos == npos) return;
+            ++pos;
+
+            bool bound = false;
+            StringToken bindingValue;
+            while (true) {
+                pos = rowJson.find_first_of("\"}", pos);
+                if (pos == npos) return;
+                if (rowJson[pos] == '}') break;
+                if ((pos = scanString(rowJson, pos, key)) == npos) return;
+
+                // Term fields are always strings in SPARQL JSON results
+                pos = rowJson.find('"', pos);
+                if (pos == npos) return;
+                if ((pos = scanString(rowJson, pos, value)) == npos) return;
+
+                if (key.text == "value") {
+                    bindingValue = value;
+                    bound = true;
+                }
+            }
+            ++pos; // Past the term's closing brace
+
+            if (bound) onValue(name.text, bindingValue);
+        }
+    }
+
+    /**
+     * @brief Decodes JSON backslash escapes (including \\uXXXX surrogate pairs to UTF-8).
+     * Also covers the string escapes of Turtle-encoded TSV terms (\\' and \\UXXXXXXXX).
+     * The output is never longer than the input, so @p out may alias @p raw for in-place decoding.
+     * @param raw String contents between the quotes.
+     * @param out Destination with room for at least raw.size() bytes.
+     * @return size_t Number of bytes written.
+     */
+    static size_t unescape(std::string_view raw, char* out) {
+        size_t written = 0;
+        for (size_t pos = 0; pos < raw.size(); ++pos) {
+            char c = raw[pos];
+            if (c != '\\' || pos + 1 == raw.size()) {
+                out[written++] = c;
+                continue;
+            }
+
+            char escape = raw[++pos];
+            switch (escape) {
+                case 'n': out[written++] = '\n'; break;
+                case 't': out[written++] = '\t'; break;
+                case 'r': out[written++] = '\r'; break;
+                case 'b': out[written++] = '\b'; break;
+                case 'f': out[written++] = '\f'; break;
+                case 'u': {
+                    uint32_t codePoint = 0;
+                    if (!readHex4(raw, pos + 1, codePoint)) {
+                        out[written++] = escape; // Malformed, keep the letter
+                        break;
+                    }
+                    pos += 4;
+
+                    // Combine a UTF-16 surrogate pair into one code point
+                    uint32_t low = 0;
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF &&
+                        pos + 2 < raw.size() && raw[pos + 1] == '\\' && raw[pos + 2] == 'u' &&
+                        readHex4(raw, pos + 3, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        pos += 6;
+                    }
+                    written += encodeUtf8(codePoint, out + written);
+                    break;
+                }
+                case 'U': {
+                    uint32_t high = 0, low = 0;
+                    if (!readHex4(raw, pos + 1, high) || !readHex4(raw, pos + 5, low) || (high << 16 | low) > 0x10FFFF) {
+                        out[written++] = escape;
+                        break;
+                    }
+                    pos += 8;
+                    written += encodeUtf8(high << 16 | low, out + written);
+                    break;
+                }
+                default: out[written++] = escape; break; // \" \\ \/ \'
+            }
+        }
+        return written;
+    }
+
+    /**
+     * @brief Assigns a string token to @p out, decoding escapes only when present.
+     */
+    template <typename Allocator>
+    static void assignString(std::basic_string<char, std::char_traits<char>, Allocator>& out, const StringToken& token) {
+        if (!token.escaped) {
+            out.assign(token.text);
+            return;
+        }
+        out.resize(token.text.size());
+        out.resize(unescape(token.text, out.data()));
+    }
+
+private:
+    static bool readHex4(std::string_view raw, size_t pos, uint32_t& value) {
+        if (pos + 4 > raw.size()) return false;
+        value = 0;
+        for (size_t i = pos; i < pos + 4; ++i) {
+            char c = raw[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+            else return false;
+        }
+        return true;
+    }
+
+    static size_t encodeUtf8(uint32_t codePoint, char* out) {
+        if (codePoint < 0x80) {
+            out[0] = static_cast<char>(codePoint);
+            return 1;
+        }
+        if (codePoint < 0x800) {
+            out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+            out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 2;
+        }
+        if (codePoint < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+            out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+        out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 4;
+    }
+};
+
+/**
+ * @brief Resumable tokenizer for the "bindings" array of a SPARQL JSON response.
+ * Successor of MiniSparqlParser::extractBindings for streamed bodies: feed it chunks as they
+ * arrive and it reports every completed binding object. Only a row that straddles a chunk
+ * boundary is copied; all other rows are handed out as views into the chunk itself.
+ * Quoted strings are tracked, so braces inside literals do not confuse it.
+ */
+class BindingsStreamParser {
+public:
+    /// Receives each complete row; return false to stop parsing.
+    using RowHandler = std::function<bool(std::string_view)>;
+
+    explicit BindingsStreamParser(RowHandler onRow) : onRow(std::move(onRow)) {}
+
+    /**
+     * @brief Consume the next piece of the response body.
+     * @param chunk Bytes following the previously fed chunk.
+     * @return false once the row handler asked to stop.
+     */
+    bool feed(std::string_view chunk) {
+        size_t pos = 0;
+        while (pos < chunk.size() && !stopped) {
+            switch (phase) {
+                case Phase::SeekingBindings: pos = seekBindings(chunk, pos); break;
+                case Phase::BetweenRows:     pos = seekRow(chunk, pos);      break;
+                case Phase::InRow:           pos = scanRow(chunk, pos);      break;
+                case Phase::Done:            return true;
+            }
+        }
+        return !stopped;
+    }
+
+    /// True once the closing ']' of the bindings array has been seen.
+    [[nodiscard]] bool finished() const { return phase == Phase::Done; }
+
+    /// Number of rows handed to the row handler so far.
+    [[nodiscard]] size_t rowCount() const { return rows; }
+
+private:
+    enum class Phase { SeekingBindings, BetweenRows, InRow, Done };
+
+    static constexpr std::string_view kBindingsKey = "bindings";
+
+    static constexpr bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    // Looks for the `"bindings" : [` token sequence.
+    size_t seekBindings(std::string_view chunk, size_t pos) {
+        for (; pos < chunk.size(); ++pos) {
+            char c = chunk[pos];
+            if (inString) {
+                if (escaped) escaped = false;
+                else if (c == '\\') escaped = true;
+                else if (c == '"') { inString = false; keyReady = true; colonSeen = false; continue; }
+                // Keys longer than "bindings" only need to be known not to match
+                if (key.size() <= kBindingsKey.size()) key.push_back(c);
+                continue;
+            }
+            if (isSpace(c)) continue;
+            if (c == '"') {
+                inString = true;
+                key.clear();
+                keyReady = false;
+                continue;
+            }
+            if (c == ':' && keyReady && !colonSeen) {
+                colonSeen = true;
+                continue;
+            }
+            if (c == '[' && keyReady && colonSeen && key == kBindingsKey) {
+                phase = Phase::BetweenRows;
+                return pos + 1;
+            }
+            keyReady = false;
+            colonSeen = false;
+        }
+        return pos;
+    }
+
+    // Skips separators until the next row object or the end of the array.
+    size_t seekRow(std::string_view chunk, size_t pos) {
+        for (; pos < chunk.size(); ++pos) {
+            if (chunk[pos] == '{') {
+                phase = Phase::InRow;
+                depth = 0;
+                return pos;
+            }
+            if (chunk[pos] == ']') {
+                phase = Phase::Done;
+                return pos + 1;
+            }
+        }
+        return pos;
+    }
+
+    // Scans a row object, emitting it once its closing brace is reached.
+    size_t scanRow(std::string_view chunk, size_t pos) {
+        const size_t segmentStart = pos;
+        for (; pos < chunk.size(); ++pos) {
+            char c = chunk[pos];
+            if (inString) {
+                if (escaped) escaped = false;
+                else if (c == '\\') escaped = true;
+                else if (c == '"') inString = false;
+                continue;
+            }
+            if (c == '"') {
+                inString = true;
+            } else if (c == '{') {
+                ++depth;
+            } else if (c == '}' && --depth == 0) {
+                std::string_view row = chunk.substr(segmentStart, pos + 1 - segmentStart);
+                if (!pending.empty()) {
+                    pending.append(row);
+                    row = pending;
+                }
+                ++rows;
+                if (!onRow(row)) stopped = true;
+                pending.clear();
+                phase = Phase::BetweenRows;
+                return pos + 1;
+            }
+        }
+        // Row continues in the next chunk
+        pending.append(chunk.substr(segmentStart));
+        return pos;
+    }
+
+    RowHandler onRow;
+    Phase phase = Phase::SeekingBindings;
+    std::string key;       // Current key while seeking "bindings"
+    std::string pending;   // Partial row spanning chunk boundaries
+    int depth = 0;
+    size_t rows = 0;
+    bool inString = false;
+    bool escaped = false;
+    bool keyReady = false;
+    bool colonSeen = false;
+    bool stopped = false;
+};
+
+/**
+ * @brief Tokenizer for the SPARQL 1.1 TSV and CSV result formats.
+ * The first line names the variables; every following line is one row. Cells are handed out
+ * as StringTokens holding the plain lexical form, ready for the member setters: TSV RDF terms
+ * are unwrapped ("text"@en, "5"^^<...#integer>, <iri>, _:b0) and CSV quoting is undone.
+ * An empty cell is an unbound variable and is not reported.
+ */
+class DelimitedResultReader {
+public:
+    /// @param format ResultFormat::Tsv or ResultFormat::Csv.
+    DelimitedResultReader(std::string_view body, ResultFormat format) : body(body), csv(format == ResultFormat::Csv) {}
+
+    /// Reads the header line and returns the variable names (without TSV's '?' prefix).
+    std::vector<std::string> readHeader() {
+        std::vector<std::string> names;
+        readRow([&](size_t column, const MiniSparqlParser::StringToken& cell) {
+            names.resize(column + 1);
+            std::string_view name = cell.text;
+            if (!name.empty() && (name[0] == '?' || name[0] == '$')) name.remove_prefix(1);
+            names[column] = name;
+        });
+        return names;
+    }
+
+    /**
+     * @brief Reads the next row.
+     * @param onCell Called as onCell(size_t column, const MiniSparqlParser::StringToken& value)
+     * for every bound cell; the value is only valid during the call.
+     * @return false once the body is exhausted.
+     */
+    template <typename F>
+    bool readRow(F&& onCell) {
+        if (pos >= body.size()) return false;
+        return csv ? readCsvRow(onCell) : readTsvRow(onCell);
+    }
+
+private:
+    template <typename F>
+    bool readTsvRow(F& onCell) {
+        // Tabs and newlines inside TSV literals are always escaped, so lines and cells split on raw bytes
+        size_t lineEnd = body.find('\n', pos);
+        if (lineEnd == std::string_view::npos) lineEnd = body.size();
+        std::string_view line = body.substr(pos, lineEnd - pos);
+        pos = lineEnd + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        size_t column = 0;
+        size_t start = 0;
+        while (true) {
+            const size_t tab = line.find('\t', start);
+            const size_t end = tab == std::string_view::npos ? line.size() : tab;
+            MiniSparqlParser::StringToken token;
+            if (end > start && decodeTerm(line.substr(start, end - start), token)) {
+                onCell(column, std::as_const(token));
+            }
+            if (tab == std::string_view::npos) return true;
+            start = tab + 1;
+            ++column;
+        }
+    }
+
+    template <typename F>
+    bool readCsvRow(F& onCell) {
+        size_t column = 0;
+        while (true) {
+            MiniSparqlParser::StringToken token;
+            if (pos < body.size() && body[pos] == '"') {
+                token.text = readQuotedCsv();
+            } else {
+                size_t end = body.find_first_of(",\r\n", pos);
+                if (end == std::string_view::npos) end = body.size();
+                token.text = body.substr(pos, end - pos);
+                pos = end;
+            }
+            if (!token.text.empty()) onCell(column, std::as_const(token));
+
+            // Anything between a closing quote and the next separator is ignored
+            const size_t separator = std::min(body.find_first_of(",\n", pos), body.size());
+            pos = separator + 1;
+            if (separator == body.size() || body[separator] == '\n') return true;
+            ++column;
+        }
+    }
+
+    // Reads a quoted CSV field starting at pos; "" stands for one quote.
+    std::string_view readQuotedCsv() {
+        const size_t start = pos + 1;
+        size_t close = body.find('"', start);
+        if (close == std::string_view::npos || close + 1 >= body.size() || body[close + 1] != '"') {
+            // No doubled quotes: the field is a plain slice of the body
+            if (close == std::string_view::npos) close = body.size();
+            pos = std::min(close + 1, body.size());
+            return body.substr(start, close - start);
+        }
+
+        scratch.clear();
+        size_t segment = start;
+        while (close != std::string_view::npos && close + 1 < body.size() && body[close + 1] == '"') {
+            scratch.append(body.substr(segment, close + 1 - segment));
+            segment = close + 2;
+            close = body.find('"', segment);
+        }
+        if (close == std::string_view::npos) close = body.size();
+        scratch.append(body.substr(segment, close - segment));
+        pos = std::min(close + 1, body.size());
+        return scratch;
+    }
+
+    /**
+     * @brief Reduces a TSV RDF term to its lexical form.
+     * Quoted literals drop their language tag or datatype; backslash escapes are left for the
+     * setters to decode (StringToken::escaped). IRIs lose their angle brackets and blank
+     * nodes their "_:" prefix; numbers and booleans are already bare.
+     */
+    static bool decodeTerm(std::string_view cell, MiniSparqlParser::StringToken& token) {
+        if (cell[0] == '"') {
+            size_t close = 1;
+            for (; close < cell.size(); ++close) {
+                if (cell[close] == '\\') {
+                    token.escaped = true;
+                    ++close;
+                } else if (cell[close] == '"') {
+                    break;
+                }
+            }
+            token.text = cell.substr(1, std::min(close, cell.size()) - 1);
+            return true;
+        }
+        if (cell[0] == '<' && cell.back() == '>') {
+            token.text = cell.substr(1, cell.size() - 2);
+        } else if (cell.starts_with("_:")) {
+            token.text = cell.substr(2);
+        } else {
+            token.text = cell;
+        }
+        return true;
+    }
+
+    std::string_view body;
+    size_t pos = 0;
+    bool csv = false;
+    std::string scratch; ///< Holds a CSV field with doubled quotes removed
+};
+
+/**
+ * @brief A bound value that could not be stored in its member.
+ */
+struct FieldError {
+    size_t row = 0;          ///< Index of the row in the response
+    std::string_view member; ///< Name of the member (static storage)
+    std::string value;       ///< The literal as it appeared in the response
+    LiteralError error = LiteralError::None;
+};
+
+/**
+ * @brief Per-response state shared by the member setters while decoding rows.
+ */
+struct DecodeContext {
+    /// Set when the rows belong to a buffer owned by the result (see SparqlResultSet):
+    /// std::string_view members may then point into it and escapes are decoded in place.
+    bool ownsBuffer = false;
+    /// Receives decode failures when set; otherwise they are dropped and the member keeps its value.
+    std::vector<FieldError>* errors = nullptr;
+    /// Row being decoded, used in error reports.
+    size_t row = 0;
+    /// Arena for std::pmr::string members; nullptr leaves them on their own resource.
+    std::pmr::memory_resource* resource = nullptr;
+
+    void report(std::string_view member, std::string_view value, LiteralError error) {
+        Metrics::add(Metrics::Counter::DecodeFailures);
+        if (errors) errors->push_back(FieldError{row, member, std::string(value), error});
+    }
+};
+
+namespace reflection_impl {
+    /// Number of non-static data members of T.
+    template <typename T>
+    consteval std::size_t memberCount() {
+        return meta::nonstatic_data_members_of(^^T, meta::access_context::unchecked()).size();
+    }
+
+    /// Non-static data members of T in declaration order, usable as constant template arguments.
+    template <typename T>
+    consteval std::array<meta::info, memberCount<T>()> memberArray() {
+        std::array<meta::info, memberCount<T>()> members{};
+        auto all = meta::nonstatic_data_members_of(^^T, meta::access_context::unchecked());
+        std::copy(all.begin(), all.end(), members.begin());
+        return members;
+    }
+
+    /// True if any member of T is a std::string_view, i.e. T must not outlive its source buffer.
+    template <typename T>
+    consteval bool hasViewMembers() {
+        for (auto member : meta::nonstatic_data_members_of(^^T, meta::access_context::unchecked())) {
+            if (meta::dealias(meta::type_of(member)) == meta::dealias(^^std::string_view)) return true;
+        }
+        return false;
+    }
+
+    /// Seeded FNV-1a over a variable name, with a final mix so the low bits are usable as a slot.
+    constexpr std::uint64_t nameHash(std::string_view name, std::uint64_t seed) {
+        std::uint64_t hash = 14695981039346656037ull ^ seed;
+        for (char c : name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+    /**
+     * @brief Compile-time perfect-hash table from SPARQL variable names to the members of T.
+     * The seed is searched at compile time until every member name lands in its own slot,
+     * so a lookup is one hash, one probe and one string compare.
+     */
+    template <typename T>
+    struct MemberDispatch {
+        static constexpr auto members = memberArray<T>();
+        static constexpr std::size_t count = members.size();
+
+        // Load factor <= 1/4 keeps the expected seed search to a handful of attempts
+        static constexpr std::size_t slotCount = std::bit_ceil(std::max<std::size_t>(count, 1) * 4);
+
+        static constexpr std::array<std::string_view, count> names = [] consteval {
+            std::array<std::string_view, count> result{};
+            for (std::size_t i = 0; i < count; ++i) {
+                result[i] = meta::identifier_of(members[i]);
+            }
+            return result;
+        }();
+
+        struct Table {
+            std::uint64_t seed = 0;
+            std::array<std::int16_t, slotCount> slots{};
+        };
+
+        static constexpr Table table = [] consteval {
+            Table result;
+            for (std::uint64_t seed = 0;; ++seed) {
+                result.seed = seed;
+                result.slots.fill(-1);
+                bool collision = false;
+                for (std::size_t i = 0; i < count && !collision; ++i) {
+                    auto& slot = result.slots[nameHash(names[i], seed) & (slotCount - 1)];
+                    collision = slot != -1;
+                    slot = static_cast<std::int16_t>(i);
+                }
+                if (!collision) return result;
+            }
+        }();
+
+        /// @return Index of the member named @p name, or -1 if T has no such member.
+        static constexpr int indexOf(std::string_view name) {
+            const int index = table.slots[nameHash(name, table.seed) & (slotCount - 1)];
+            return (index >= 0 && names[index] == name) ? index : -1;
+        }
+    };
+
+    /**
+     * @brief Stores the string returned by Make() in a constexpr array, so text that is
+     * assembled at compile time ends up as read-only data in the binary.
+     * Make is a constexpr function returning std::string (its allocation stays transient).
+     */
+    template <auto Make>
+    struct StaticText {
+        static constexpr std::size_t size = Make().size();
+
+        static constexpr std::array<char, size + 1> chars = [] {
+            std::array<char, size + 1> result{};
+            const std::string text = Make();
+            std::copy(text.begin(), text.end(), result.begin());
+            return result;
+        }();
+
+        static constexpr std::string_view view() { return std::string_view(chars.data(), size); }
+    };
+
+    /// "SELECT ?member1 ?member2 ..." for the members of T.
+    template <typename T>
+    constexpr std::string selectText() {
+        std::string text = "SELECT";
+        for (std::string_view name : MemberDispatch<T>::names) {
+            text += " ?";
+            text += name;
+        }
+        return text;
+    }
+
+    /// True if any member of T is a C array (not representable as a column).
+    template <typename T>
+    consteval bool hasArrayMembers() {
+        for (auto member : meta::nonstatic_data_members_of(^^T, meta::access_context::unchecked())) {
+            if (meta::is_array_type(meta::dealias(meta::type_of(member)))) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Converts a bound value and stores it in a member, based on the member's type.
+     * Strings are copied (or viewed), Interned members are looked up in their dictionary,
+     * std::optional wraps any supported type, and every other
+     * scalar goes through LiteralDecoder. Values that do not convert leave the member untouched.
+     * @return LiteralError::None, or why the value was rejected.
+     */
+    template <typename MemberType>
+    LiteralError assignValue(MemberType& out, const MiniSparqlParser::StringToken& value, DecodeContext& context) {
+        if constexpr (std::is_same_v<MemberType, std::string>) {
+            MiniSparqlParser::assignString(out, value);
+        }
+        else if constexpr (std::is_same_v<MemberType, std::pmr::string>) {
+            // Value-initialized members sit on the default resource; move them onto the arena
+            // (assignment would keep the old allocator)
+            if (context.resource && out.get_allocator().resource() != context.resource) {
+                std::destroy_at(&out);
+                std::construct_at(&out, context.resource);
+            }
+            MiniSparqlParser::assignString(out, value);
+        }
+        else if constexpr (std::is_same_v<MemberType, std::string_view>) {
+            // Point into the response buffer; escapes shrink the text, so decode them in place
+            if (value.escaped && context.ownsBuffer) {
+                char* text = const_cast<char*>(value.text.data());
+                out = std::string_view(text, MiniSparqlParser::unescape(value.text, text));
+            } else {
+                out = value.text;
+            }
+        }
+        else if constexpr (LiteralDecoder::isSpecializationOf<MemberType, ^^Interned>()) {
+            if (!value.escaped) {
+                out = MemberType(value.text);
+            } else {
+                std::string text;
+                MiniSparqlParser::assignString(text, value);
+                out = MemberType(text);
+            }
+        }
+        else if constexpr (LiteralDecoder::isOptional<MemberType>) {
+            typename MemberType::value_type inner{};
+            const LiteralError error = assignValue(inner, value, context);
+            if (error == LiteralError::None) out = std::move(inner);
+            return error;
+        }
+        else {
+            static_assert(LiteralDecoder::supports<MemberType>, "Unsupported member type for SPARQL decoding");
+            if (!value.escaped) return LiteralDecoder::decode(value.text, out);
+
+            // Typed literals practically never contain escapes; decode them into a scratch copy
+            std::string text(value.text.size(), '\0');
+            text.resize(MiniSparqlParser::unescape(value.text, text.data()));
+            return LiteralDecoder::decode(text, out);
+        }
+        return LiteralError::None;
+    }
+
+    /**
+     * @brief Appends one member value to @p out: optionals as their value or "null", enums by name,
+     * text as is, everything else through std::format_to.
+     */
+    template <typename V>
+    void formatValue(std::string& out, const V& value) {
+        if constexpr (LiteralDecoder::isOptional<V>) {
+            if (value) formatValue(out, *value);
+            else out += "null";
+        }
+        else if constexpr (std::is_enum_v<V>) {
+            const std::string_view name = LiteralDecoder::enumName(value);
+            if (!name.empty()) out += name;
+            else std::format_to(std::back_inserter(out), "{}", std::to_underlying(value));
+        }
+        else if constexpr (LiteralDecoder::isCharBuffer<V>()) {
+            out += LiteralDecoder::bufferText(value);
+        }
+        else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+            out += std::string_view(value);
+        }
+        else {
+            std::format_to(std::back_inserter(out), "{}", value);
+        }
+    }
+
+    /**
+     * @brief Jump table of per-member setters, indexed like MemberDispatch<T>::members.
+     */
+    template <typename T>
+    struct MemberSetters {
+        using Setter = void (*)(T&, const MiniSparqlParser::StringToken&, DecodeContext&);
+
+        template <std::size_t I>
+        static void set(T& item, const MiniSparqlParser::StringToken& value, DecodeContext& context) {
+            const LiteralError error = assignValue(item.[:MemberDispatch<T>::members[I]:], value, context);
+            if (error != LiteralError::None) context.report(MemberDispatch<T>::names[I], value.text, error);
+        }
+
+        template <std::size_t... I>
+        static consteval auto build(std::index_sequence<I...>) {
+            return std::array<Setter, sizeof...(I)>{ &set<I>... };
+        }
+
+        static constexpr auto table = build(std::make_index_sequence<MemberDispatch<T>::count>{});
+    };
+
+    /**
+     * @brief Jump tables appending a bound value (or a null) to each column of ColumnsFor<T>.
+     * Columns are declared in the same order as T's members, so indices match MemberDispatch<T>.
+     */
+    template <typename T>
+    struct ColumnAppenders {
+        using Columns = ColumnsFor<T>;
+        using Appender = void (*)(Columns&, const MiniSparqlParser::StringToken&, DecodeContext&);
+        using NullAppender = void (*)(Columns&);
+
+        static constexpr auto columns = memberArray<Columns>();
+
+        template <std::size_t I>
+        static void append(Columns& target, const MiniSparqlParser::StringToken& value, DecodeContext& context) {
+            auto& column = target.[:columns[I]:];
+            // An optional member decodes into its value type; a missing value is only a validity bit
+            using ValueType = ColumnValueT<typename [: meta::type_of(MemberDispatch<T>::members[I]) :]>;
+
+            if constexpr (std::is_same_v<ValueType, std::string>) {
+                // Decode straight into the packed character buffer
+                if (value.escaped) {
+                    column.appendWith(value.text.size(), [&](char* dest) {
+                        return MiniSparqlParser::unescape(value.text, dest);
+                    });
+                } else {
+                    column.append(value.text);
+                }
+            } else {
+                ValueType decoded{};
+                const LiteralError error = assignValue(decoded, value, context);
+                if (error == LiteralError::None) {
+                    column.append(std::move(decoded));
+                } else {
+                    context.report(MemberDispatch<T>::names[I], value.text, error);
+                    column.appendNull();
+                }
+            }
+        }
+
+        template <std::size_t I>
+        static void appendNull(Columns& target) {
+            target.[:columns[I]:].appendNull();
+        }
+
+        template <std::size_t I>
+        static void reserve(Columns& target, size_t rows) {
+            target.[:columns[I]:].reserve(rows);
+        }
+
+        template <std::size_t... I>
+        static consteval auto buildValues(std::index_sequence<I...>) {
+            return std::array<Appender, sizeof...(I)>{ &append<I>... };
+        }
+
+        template <std::size_t... I>
+        static consteval auto buildNulls(std::index_sequence<I...>) {
+            return std::array<NullAppender, sizeof...(I)>{ &appendNull<I>... };
+        }
+
+        static constexpr auto values = buildValues(std::make_index_sequence<MemberDispatch<T>::count>{});
+        static constexpr auto nulls = buildNulls(std::make_index_sequence<MemberDispatch<T>::count>{});
+
+        /// Reserves room for @p rows rows in every column.
+        static void reserveAll(Columns& target, size_t rows) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (reserve<I>(target, rows), ...);
+            }(std::make_index_sequence<MemberDispatch<T>::count>{});
+        }
+    };
+
+    /// Transparent string hash, so keys held as std::string can be looked up by std::string_view.
+    struct TextHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+    };
+
+    template <typename T, std::size_t I>
+    using MemberTypeAt = typename [: meta::type_of(MemberDispatch<T>::members[I]) :];
+
+    /// True if V is a std::vector of reflected structs, i.e. a group of child rows.
+    template <typename V>
+    consteval bool isChildGroup() {
+        if constexpr (LiteralDecoder::isSpecializationOf<V, ^^std::vector>()) {
+            using Child = typename V::value_type;
+            return std::is_class_v<Child> && std::is_aggregate_v<Child> && !LiteralDecoder::isCharBuffer<Child>();
+        }
+        return false;
+    }
+
+    template <typename T>
+    consteval bool hasGroupedViewMembers();
+
+    template <typename V>
+    consteval bool childHasViewMembers() {
+        if constexpr (isChildGroup<V>()) return hasGroupedViewMembers<typename V::value_type>();
+        else return false;
+    }
 
-        // Find the opening brace of this variable's object '{'
-        // Skip whitespace after key
-        size_t objStart = rowJson.find('{', keyPos);
-        if (objStart == std::string_view::npos) return "";
+    /// hasViewMembers for T and, recursively, the struct of every child group of T.
+    template <typename T>
+    consteval bool hasGroupedViewMembers() {
+        return hasViewMembers<T>() || []<std::size_t... I>(std::index_sequence<I...>) {
+            return (childHasViewMembers<MemberTypeAt<T, I>>() || ...);
+        }(std::make_index_sequence<MemberDispatch<T>::count>{});
+    }
+
+    /// Columns taken by member I: one for a scalar, one per child member for a group.
+    template <typename T, std::size_t I>
+    consteval std::size_t groupColumnWidth() {
+        using V = MemberTypeAt<T, I>;
+        if constexpr (isChildGroup<V>()) return MemberDispatch<typename V::value_type>::count;
+        else return 1;
+    }
+
+    template <typename T>
+    consteval auto groupColumnOffsets() {
+        constexpr std::size_t count = MemberDispatch<T>::count;
+        std::array<std::size_t, count + 1> offsets{};
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            std::size_t next = 0;
+            ((offsets[I] = next, next += groupColumnWidth<T, I>()), ...);
+            offsets[count] = next;
+        }(std::make_index_sequence<count>{});
+        return offsets;
+    }
+
+    /**
+     * @brief Row layout for grouped parsing: the scalar members of T, followed in place by the
+     * members of each child struct held in a std::vector member. One binding can feed several
+     * columns (a parent and a child may both read the same variable).
+     */
+    template <typename T>
+    struct GroupedRows {
+        using Dispatch = MemberDispatch<T>;
+        using Token = MiniSparqlParser::StringToken;
+        using ChildKeys = std::unordered_set<std::string, TextHash, std::equal_to<>>;
+
+        static constexpr auto offsets = groupColumnOffsets<T>();
+        using Row = std::array<Token, offsets[Dispatch::count]>;
+
+        static void route(std::string_view name, const Token& value, Row& row) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (routeMember<I>(name, value, row), ...);
+            }(std::make_index_sequence<Dispatch::count>{});
+        }
+
+        /// Raw text of the scalar columns, length-prefixed so that no two keys collide.
+        static void parentKey(std::string& key, const Row& row) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((isChildGroup<MemberTypeAt<T, I>>() ? void() : appendKey(key, row[offsets[I]])), ...);
+            }(std::make_index_sequence<Dispatch::count>{});
+        }
+
+        static T decodeParent(const Row& row, DecodeContext& context) {
+            T item{};
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (decodeScalar<I>(item, row, context), ...);
+            }(std::make_index_sequence<Dispatch::count>{});
+            return item;
+        }
+
+        /// Appends each child bound in @p row to its group, unless the parent already has it.
+        static void attachChildren(T& item, std::size_t parent, const Row& row, ChildKeys& seen, std::string& key,
+                                   DecodeContext& context) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (attachChild<I>(item, parent, row, seen, key, context), ...);
+            }(std::make_index_sequence<Dispatch::count>{});
+        }
 
-        // Inside this object, find "value" key
-        size_t valueLabelPos = rowJson.find("\"value\"", objStart);
-        if (valueLabelPos == std::string_view::npos) return "";
+    private:
+        static void appendKey(std::string& key, const Token& token) {
+            key += std::to_string(token.text.size());
+            key += ':';
+            key += token.text;
+        }
 
-        // Find the colon after "value"
-        size_t colonPos = rowJson.find(':', valueLabelPos);
-        if (colonPos == std::string_view::npos) return "";
+        template <std::size_t I>
+        static void routeMember(std::string_view name, const Token& value, Row& row) {
+            using V = MemberTypeAt<T, I>;
+            if constexpr (isChildGroup<V>()) {
+                const int index = MemberDispatch<typename V::value_type>::indexOf(name);
+                if (index >= 0) row[offsets[I] + index] = value;
+            } else if (name == Dispatch::names[I]) {
+                row[offsets[I]] = value;
+            }
+        }
 
-        // Find the opening quote of the actual value, skipping whitespace/newlines
-        size_t valueStartQuote = std::string_view::npos;
-        for (size_t i = colonPos + 1; i < rowJson.length(); ++i) {
-            if (rowJson[i] == '"') {
-                valueStartQuote = i;
-                break;
+        template <std::size_t I>
+        static void decodeScalar(T& item, const Row& row, DecodeContext& context) {
+            if constexpr (!isChildGroup<MemberTypeAt<T, I>>()) {
+                const Token& value = row[offsets[I]];
+                if (value.text.empty()) return;
+                const LiteralError error = assignValue(item.[:Dispatch::members[I]:], value, context);
+                if (error != LiteralError::None) context.report(Dispatch::names[I], value.text, error);
             }
         }
-        if (valueStartQuote == std::string_view::npos) return "";
 
-        // Find the closing quote (handling escaped quotes is skipped for simplicity)
-        size_t valueEndQuote = rowJson.find('"', valueStartQuote + 1);
-        if (valueEndQuote == std::string_view::npos) return "";
+        template <std::size_t I>
+        static void attachChild(T& item, std::size_t parent, const Row& row, ChildKeys& seen, std::string& key,
+                                DecodeContext& context) {
+            using V = MemberTypeAt<T, I>;
+            if constexpr (isChildGroup<V>()) {
+                using Child = typename V::value_type;
+                constexpr auto& setters = MemberSetters<Child>::table;
+                const auto columns = std::span(row).subspan(offsets[I], MemberDispatch<Child>::count);
+                if (std::ranges::all_of(columns, [](const Token& token) { return token.text.empty(); })) return; // Unbound OPTIONAL
+
+                key.clear();
+                key += std::to_string(parent);
+                key += '/';
+                key += std::to_string(I);
+                for (const Token& token : columns) appendKey(key, token);
+                if (!seen.emplace(key).second) return; // Repeated by another join
+
+                Child child{};
+                for (std::size_t k = 0; k < columns.size(); ++k) {
+                    if (!columns[k].text.empty()) setters[k](child, columns[k], context);
+                }
+                item.[:Dispatch::members[I]:].push_back(std::move(child));
+            }
+        }
+    };
+}
 
-        return std::string(rowJson.substr(valueStartQuote + 1, valueEndQuote - valueStartQuote - 1));
+/**
+ * @brief Parsed rows together with the response buffer they were decoded from.
+ * std::string_view members of T point into the buffer, so it lives exactly as long as the
+ * result set. Move-only: the buffer is heap-held, so moving keeps every view valid.
+ */
+template <typename T>
+class SparqlResultSet {
+public:
+    SparqlResultSet() = default;
+
+    SparqlResultSet(std::unique_ptr<std::string> buffer, std::vector<T> rows)
+        : storage(std::move(buffer)), items(std::move(rows)) {}
+
+    SparqlResultSet(SparqlResultSet&&) noexcept = default;
+    SparqlResultSet& operator=(SparqlResultSet&&) noexcept = default;
+    SparqlResultSet(const SparqlResultSet&) = delete;
+    SparqlResultSet& operator=(const SparqlResultSet&) = delete;
+
+    [[nodiscard]] size_t size() const { return items.size(); }
+    [[nodiscard]] bool empty() const { return items.empty(); }
+
+    const T& operator[](size_t index) const { return items[index]; }
+    auto begin() const { return items.begin(); }
+    auto end() const { return items.end(); }
+
+    /// The decoded rows.
+    [[nodiscard]] const std::vector<T>& rows() const { return items; }
+
+    /// The raw response the rows point into (escaped strings are decoded in place).
+    [[nodiscard]] std::string_view buffer() const {
+        return storage ? std::string_view(*storage) : std::string_view();
     }
+
+private:
+    std::unique_ptr<std::string> storage;
+    std::vector<T> items;
 };
 
 /**
@@ -134,6 +1158,16 @@ public:
  */
 class SparqlReflector {
 public:
+    /// Public Wikidata query service used when no endpoint is given.
+    static constexpr std::string_view kDefaultEndpoint = "https://query.wikidata.org/sparql";
+
+    /**
+     * @brief Builds the GET URL for a query: "<endpoint>?query=<url-encoded query>".
+     */
+    static std::string buildQueryUrl(std::string_view endpoint, const std::string& query) {
+        return std::format("{}?query={}", endpoint, NetworkClient::urlEncode(query));
+    }
+
     // Helper function to expand a range into a splice-able replicator.
     template<typename R>
     static consteval auto expand(R range) {
@@ -145,30 +1179,54 @@ public:
     }
 
     /**
-     * @brief Automatically prints any C++ struct to the console using Reflection.
-     * @tparam T Any struct with members.
-     * @param obj The object to print.
+     * @brief Appends the line printStruct() prints for @p obj to @p out.
+     * Format many rows this way and print them at once; for bulk output see BulkExporter.
      */
     template <typename T>
-    static void printStruct(const T& obj) {
+    static void formatStruct(std::string& out, const T& obj) {
         constexpr auto type_meta = ^^T;
-        
-        std::print("  [ ");
-        
+
+        out += "  [ ";
+
         bool is_first = true;
-        
+
         // Iterate over all members of the struct
         [:expand(meta::members_of(type_meta, meta::access_context::unchecked())):] >> [&]<auto member>{
             if constexpr (meta::is_nonstatic_data_member(member)) {
-                if (!is_first) std::print(" | ");
-                
-                // Print "MemberName: Value"
-                std::print("{}: {}", meta::identifier_of(member), obj.[:member:]);
+                if (!is_first) out += " | ";
+
+                // "MemberName: Value"
+                out += meta::identifier_of(member);
+                out += ": ";
+                reflection_impl::formatValue(out, obj.[:member:]);
                 is_first = false;
             }
         };
-        
-        std::println(" ]");
+
+        out += " ]\n";
+    }
+
+    /**
+     * @brief Automatically prints any C++ struct to the console using Reflection.
+     * The line is formatted first and written with a single call.
+     * @tparam T Any struct with members.
+     * @param obj The object to print.
+     */
+    template <typename T>
+    static void printStruct(const T& obj) {
+        std::string line;
+        formatStruct(line, obj);
+        std::print("{}", line);
+    }
+
+    /**
+     * @brief The SPARQL SELECT clause for a struct type, assembled at compile time.
+     * @tparam T The struct type to reflect upon.
+     * @return A view of static storage formatted as "SELECT ?member1 ?member2 ..."
+     */
+    template <typename T>
+    static constexpr std::string_view selectClause() {
+        return reflection_impl::StaticText<reflection_impl::selectText<T>>::view();
     }
 
     /**
@@ -178,21 +1236,30 @@ public:
      */
     template <typename T>
     static std::string generateSelectClause() {
-        std::stringstream ss;
-        ss << "SELECT";
-
-        using ReflectedType = T;
-        constexpr auto type_meta = ^^ReflectedType;
+        return std::string(selectClause<T>());
+    }
 
-        // P2996R10+: members_of requires an access_context argument.
-        [:expand(meta::members_of(type_meta, meta::access_context::unchecked())):] >> [&]<auto member>{
-            if constexpr (meta::is_nonstatic_data_member(member)) {
-                constexpr auto name = meta::identifier_of(member);
-                ss << " ?" << name;
+    /**
+     * @brief Compile-time fingerprint of T's layout: member names and types in declaration order.
+     * Changes whenever a member is added, removed, renamed, reordered or retyped, so it can
+     * tag anything persisted for T (cache entries, snapshots).
+     */
+    template <typename T>
+    static consteval std::uint64_t layoutFingerprint() {
+        std::uint64_t hash = 14695981039346656037ull;
+        auto mix = [&](std::string_view text) {
+            for (char c : text) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
             }
+            hash ^= 0xFF; // Field separator
+            hash *= 1099511628211ull;
         };
-
-        return ss.str();
+        for (auto member : meta::nonstatic_data_members_of(^^T, meta::access_context::unchecked())) {
+            mix(meta::identifier_of(member));
+            mix(meta::display_string_of(meta::dealias(meta::type_of(member))));
+        }
+        return hash;
     }
 
     /**
@@ -201,78 +1268,436 @@ public:
      */
     template <typename T>
     static std::string buildSimpleQuery(std::string_view whereClause, int limit = 10) {
-        std::string select = generateSelectClause<T>();
-        return std::format("{} WHERE {} LIMIT {}", select, whereClause, limit);
+        Metrics::ScopedTimer timer(Metrics::Phase::QueryBuild);
+        return std::format("{} WHERE {} LIMIT {}", selectClause<T>(), whereClause, limit);
+    }
+
+    /**
+     * @brief Maps a single binding object onto struct T using Reflection.
+     * The row is scanned once; variable names are resolved through a compile-time
+     * perfect-hash table and written directly into the matching member.
+     * @tparam T The target struct type to populate.
+     * @param rowJson The JSON object for one row, as produced by the bindings extractors.
+     * @return T The populated object; members without a binding stay value-initialized.
+     */
+    template <typename T>
+    static T parseRow(std::string_view rowJson) {
+        static_assert(!reflection_impl::hasViewMembers<T>(),
+                      "std::string_view members need an owned buffer: use parseJsonResponseInPlace");
+        DecodeContext context;
+        return decodeRow<T>(rowJson, context);
     }
 
     /**
      * @brief Parses a SPARQL JSON response into a vector of struct T using Reflection and a custom mini-parser.
      * @tparam T The target struct type to populate.
      * @param rawJson The raw JSON string returned by the SPARQL endpoint.
+     * @param errors Optional side channel receiving every value that failed to decode.
      * @return std::vector<T> A list of populated objects.
      */
     template <typename T>
-    static std::vector<T> parseJsonResponse(const std::string& rawJson) {
+    static std::vector<T> parseJsonResponse(std::string_view rawJson, std::vector<FieldError>* errors = nullptr) {
+        static_assert(!reflection_impl::hasViewMembers<T>(),
+                      "std::string_view members need an owned buffer: use parseJsonResponseInPlace");
         std::vector<T> results;
+        DecodeContext context{ .errors = errors };
+        Metrics::Stopwatch watch;
         
-        // 1. Extract raw JSON strings for each row
-        auto rows = MiniSparqlParser::extractBindings(rawJson);
+        // 1. Locate each row inside the response (no copies)
+        auto rows = MiniSparqlParser::extractBindingViews(rawJson);
+        watch.lap(Metrics::Phase::BindingsExtraction);
+        results.reserve(rows.size());
+        watch.lap(Metrics::Phase::Materialization);
 
         // 2. Iterate over rows and map to C++ struct using Reflection
-        for (const auto& rowJson : rows) {
-            T item{}; // Value initialization (important for ints to be 0)
-            using ReflectedType = T;
-            constexpr auto type_meta = ^^ReflectedType;
-
-            // Reflection Loop: Iterate over struct members
-            [:expand(meta::members_of(type_meta, meta::access_context::unchecked())):] >> [&]<auto member>{
-                if constexpr (meta::is_nonstatic_data_member(member)) {
-                    // Get compile-time name of the member (e.g., "itemLabel")
-                    constexpr auto nameView = meta::identifier_of(member);
-                    
-                    // Extract value from JSON using our mini-parser
-                    std::string value = MiniSparqlParser::extractValue(rowJson, nameView);
-                    
-                    if (!value.empty()) {
-                        // Get the type of the member to perform correct conversion
-                        using MemberType = typename [: meta::type_of(member) :];
-
-                        // Assign based on type
-                        if constexpr (std::is_same_v<MemberType, std::string>) {
-                            item.[:member:] = value;
-                        } 
-                        else if constexpr (std::is_integral_v<MemberType>) {
-                            // Convert string to integer type (int, long, size_t, etc.)
-                            try {
-                                item.[:member:] = static_cast<MemberType>(std::stoll(value));
-                            } catch (...) {
-                                // Ignore conversion errors in this simple parser
-                            }
-                        }
-                        else if constexpr (std::is_floating_point_v<MemberType>) {
-                            // Convert string to floating point (float, double)
-                            try {
-                                item.[:member:] = static_cast<MemberType>(std::stod(value));
-                            } catch (...) {
-                                // Ignore errors
-                            }
-                        }
+        for (std::string_view rowJson : rows) {
+            context.row = results.size();
+            results.push_back(decodeRow<T>(rowJson, context));
+        }
+        watch.lap(Metrics::Phase::MemberDecode);
+        Metrics::add(Metrics::Counter::Rows, results.size());
+        return results;
+    }
+
+    /**
+     * @brief parseJsonResponse with every allocation for the response drawn from @p resource:
+     * the row index, the result vector and the std::pmr::string members of T (std::string
+     * members still use the global heap). With a std::pmr::monotonic_buffer_resource the whole
+     * result is released at once by releasing the arena, which must outlive the result.
+     * @param resource Arena for the response; typically reused across responses by one thread.
+     * @param errors Optional side channel receiving every value that failed to decode.
+     */
+    template <typename T>
+    static std::pmr::vector<T> parseJsonResponse(std::string_view rawJson, std::pmr::memory_resource* resource,
+                                                 std::vector<FieldError>* errors = nullptr) {
+        static_assert(!reflection_impl::hasViewMembers<T>(),
+                      "std::string_view members need an owned buffer: use parseJsonResponseInPlace");
+        std::pmr::vector<T> results(resource);
+        DecodeContext context{ .errors = errors, .resource = resource };
+        Metrics::Stopwatch watch;
+
+        auto rows = MiniSparqlParser::extractBindingViews(rawJson, resource);
+        watch.lap(Metrics::Phase::BindingsExtraction);
+        results.reserve(rows.size());
+        watch.lap(Metrics::Phase::Materialization);
+
+        for (std::string_view rowJson : rows) {
+            context.row = results.size();
+            results.push_back(decodeRow<T>(rowJson, context));
+        }
+        watch.lap(Metrics::Phase::MemberDecode);
+        Metrics::add(Metrics::Counter::Rows, results.size());
+        return results;
+    }
+
+    /**
+     * @brief Parses a text/tab-separated-values or text/csv response into a vector of struct T.
+     * Header columns are mapped to members once; rows are then split on raw delimiter bytes
+     * and every cell goes straight to its member's setter.
+     * @param body The response body.
+     * @param format ResultFormat::Tsv or ResultFormat::Csv.
+     * @param errors Optional side channel receiving every value that failed to decode.
+     */
+    template <typename T>
+    static std::vector<T> parseDelimitedResponse(std::string_view body, ResultFormat format,
+                                                 std::vector<FieldError>* errors = nullptr) {
+        static_assert(!reflection_impl::hasViewMembers<T>(),
+                      "std::string_view members need an owned buffer: use parseJsonResponseInPlace");
+        using Dispatch = reflection_impl::MemberDispatch<T>;
+        constexpr auto& setters = reflection_impl::MemberSetters<T>::table;
+
+        Metrics::Stopwatch watch;
+        DelimitedResultReader reader(body, format);
+        std::vector<int> columnMembers;
+        for (const std::string& name : reader.readHeader()) {
+            columnMembers.push_back(Dispatch::indexOf(name));
+        }
+
+        std::vector<T> results;
+        results.reserve(static_cast<size_t>(std::count(body.begin(), body.end(), '\n')));
+        DecodeContext context{ .errors = errors };
+        watch.lap(Metrics::Phase::Materialization);
+
+        while (true) {
+            T item{};
+            context.row = results.size();
+            const bool more = reader.readRow([&](size_t column, const MiniSparqlParser::StringToken& value) {
+                if (column < columnMembers.size() && columnMembers[column] >= 0) {
+                    setters[columnMembers[column]](item, value, context);
+                }
+            });
+            if (!more) break;
+            results.push_back(std::move(item));
+        }
+        // Rows are split and decoded in the same pass
+        watch.lap(Metrics::Phase::MemberDecode);
+        Metrics::add(Metrics::Counter::Rows, results.size());
+        return results;
+    }
+
+    /**
+     * @brief Parses a response in any supported format into a vector of struct T.
+     */
+    template <typename T>
+    static std::vector<T> parseResponse(std::string_view body, ResultFormat format, std::vector<FieldError>* errors = nullptr) {
+        if (format == ResultFormat::Json) return parseJsonResponse<T>(body, errors);
+        return parseDelimitedResponse<T>(body, format, errors);
+    }
+
+    /**
+     * @brief Multi-threaded variant of parseJsonResponse with identical results.
+     * Row boundaries are found serially, by one pass of the SIMD structural scanner; only the
+     * member decoding is parallel. The rows are split into contiguous chunks, each writing
+     * straight into its slots of the result, so the output keeps the response order without a
+     * stitching copy. The calling thread decodes chunks too and only waits for chunks already
+     * running elsewhere, so it may itself be a worker of @p pool.
+     * @param pool Workers to decode on.
+     * @param minRowsPerChunk Smaller inputs are not worth splitting and are decoded inline.
+     * @param errors Optional side channel receiving decode failures, in row order.
+     */
+    template <typename T>
+    static std::vector<T> parseJsonResponseParallel(std::string_view rawJson, ThreadPool& pool, size_t minRowsPerChunk = 4096,
+                                                    std::vector<FieldError>* errors = nullptr) {
+        static_assert(!reflection_impl::hasViewMembers<T>(),
+                      "std::string_view members need an owned buffer: use parseJsonResponseInPlace");
+
+        Metrics::Stopwatch watch;
+        auto rows = MiniSparqlParser::extractBindingViews(rawJson);
+        watch.lap(Metrics::Phase::BindingsExtraction);
+        std::vector<T> results(rows.size());
+        watch.lap(Metrics::Phase::Materialization);
+        Metrics::add(Metrics::Counter::Rows, rows.size());
+
+        // A few chunks per worker evens out rows of different sizes
+        const size_t chunkCount = std::min(rows.size() / std::max<size_t>(minRowsPerChunk, 1), pool.size() * 4);
+        std::vector<std::vector<FieldError>> chunkErrors(std::max<size_t>(chunkCount, 1));
+        auto decodeRange = [&](size_t chunk, size_t begin, size_t end) {
+            DecodeContext context{ .errors = errors ? &chunkErrors[chunk] : nullptr };
+            for (size_t i = begin; i < end; ++i) {
+                context.row = i;
+                results[i] = decodeRow<T>(rows[i], context);
+            }
+        };
+        auto collectErrors = [&] {
+            if (!errors) return;
+            for (auto& found : chunkErrors) {
+                errors->insert(errors->end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+            }
+        };
+
+        if (chunkCount <= 1) {
+            decodeRange(0, 0, rows.size());
+            watch.lap(Metrics::Phase::MemberDecode);
+            collectErrors();
+            return results;
+        }
+
+        // Chunks are claimed from a shared counter by the caller and the helpers alike. A helper
+        // that starts after every chunk was claimed returns without touching the locals.
+        struct Progress {
+            std::function<void(size_t)> decode;
+            size_t chunkCount;
+            std::atomic<size_t> next{0};
+            size_t done = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable finished;
+
+            void drain() {
+                for (size_t chunk; (chunk = next.fetch_add(1)) < chunkCount;) {
+                    std::exception_ptr failure;
+                    try {
+                        decode(chunk);
+                    } catch (...) {
+                        failure = std::current_exception();
                     }
+                    std::lock_guard lock(mutex);
+                    if (failure && !error) error = failure;
+                    if (++done == chunkCount) finished.notify_all();
                 }
-            };
-            
-            results.push_back(item);
+            }
+        };
+        auto progress = std::make_shared<Progress>();
+        progress->chunkCount = chunkCount;
+        progress->decode = [&decodeRange, &rows, chunkCount](size_t chunk) {
+            decodeRange(chunk, rows.size() * chunk / chunkCount, rows.size() * (chunk + 1) / chunkCount);
+        };
+
+        for (size_t i = 0, helpers = std::min(chunkCount - 1, pool.size()); i < helpers; ++i) {
+            pool.submit([progress] { progress->drain(); });
+        }
+        progress->drain();
+
+        // Every claimed chunk references locals: wait for all of them before propagating an error
+        {
+            std::unique_lock lock(progress->mutex);
+            progress->finished.wait(lock, [&] { return progress->done == chunkCount; });
+        }
+        watch.lap(Metrics::Phase::MemberDecode); // Wall time across all workers
+        if (progress->error) std::rethrow_exception(progress->error);
+        collectErrors();
+        return results;
+    }
+
+    /**
+     * @brief Convenience overload running on a temporary pool.
+     * @param threads Number of workers; 0 means one per hardware thread.
+     */
+    template <typename T>
+    static std::vector<T> parseJsonResponseParallel(std::string_view rawJson, size_t threads = 0) {
+        ThreadPool pool(threads);
+        return parseJsonResponseParallel<T>(rawJson, pool);
+    }
+
+    /**
+     * @brief Parses a denormalized result into parent structs with their children attached.
+     * Every std::vector<Child> member of T (Child being a reflected struct) is a group: its
+     * variables are the members of Child. The remaining members of T are the key. Rows are
+     * hash-joined on the raw text of the key columns, so each parent is decoded once, in
+     * first-seen order, and each distinct child once per parent. Rows that only repeat a
+     * child because of another join are never materialized.
+     * @code
+     * struct Creator { std::string creatorLabel; };
+     * struct Language { std::string langLabel; std::vector<Creator> creators; };
+     * auto languages = SparqlReflector::parseJsonResponseGrouped<Language>(json);
+     * @endcode
+     * @param rawJson The raw JSON string returned by the SPARQL endpoint.
+     * @param errors Optional side channel receiving every value that failed to decode.
+     */
+    template <typename T>
+    static std::vector<T> parseJsonResponseGrouped(std::string_view rawJson, std::vector<FieldError>* errors = nullptr) {
+        static_assert(!reflection_impl::hasGroupedViewMembers<T>(),
+                      "std::string_view members (of T or of a child group) would dangle; use std::string");
+        using Grouped = reflection_impl::GroupedRows<T>;
+
+        std::vector<T> results;
+        DecodeContext context{ .errors = errors };
+        Metrics::Stopwatch watch;
+
+        auto rows = MiniSparqlParser::extractBindingViews(rawJson);
+        watch.lap(Metrics::Phase::BindingsExtraction);
+
+        std::unordered_map<std::string, size_t, reflection_impl::TextHash, std::equal_to<>> parents;
+        typename Grouped::ChildKeys children;
+        typename Grouped::Row columns;
+        std::string key;
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            context.row = i;
+            columns.fill({});
+            MiniSparqlParser::forEachBinding(rows[i], [&](std::string_view name, const MiniSparqlParser::StringToken& value) {
+                Grouped::route(name, value, columns);
+            });
+
+            key.clear();
+            Grouped::parentKey(key, columns);
+            size_t parent;
+            if (auto it = parents.find(std::string_view(key)); it != parents.end()) {
+                parent = it->second;
+            } else {
+                parent = results.size();
+                parents.emplace(key, parent);
+                results.push_back(Grouped::decodeParent(columns, context));
+            }
+            Grouped::attachChildren(results[parent], parent, columns, children, key, context);
         }
+        watch.lap(Metrics::Phase::MemberDecode);
+        Metrics::add(Metrics::Counter::Rows, rows.size());
         return results;
     }
 
+    /**
+     * @brief Zero-copy parse: takes ownership of the response and decodes rows in place.
+     * T may declare std::string_view members; they point into the buffer held by the
+     * returned result set, so neither rows nor values are copied.
+     * @tparam T The target struct type to populate.
+     * @param rawJson The response body, moved into the result.
+     * @param errors Optional side channel receiving every value that failed to decode.
+     * @return SparqlResultSet<T> The rows together with the buffer backing them.
+     */
+    template <typename T>
+    static SparqlResultSet<T> parseJsonResponseInPlace(std::string rawJson, std::vector<FieldError>* errors = nullptr) {
+        auto buffer = std::make_unique<std::string>(std::move(rawJson));
+        std::vector<T> results;
+        DecodeContext context{ .ownsBuffer = true, .errors = errors };
+        Metrics::Stopwatch watch;
+
+        auto rows = MiniSparqlParser::extractBindingViews(*buffer);
+        watch.lap(Metrics::Phase::BindingsExtraction);
+        results.reserve(rows.size());
+        watch.lap(Metrics::Phase::Materialization);
+
+        for (std::string_view rowJson : rows) {
+            context.row = results.size();
+            results.push_back(decodeRow<T>(rowJson, context));
+        }
+        watch.lap(Metrics::Phase::MemberDecode);
+        Metrics::add(Metrics::Counter::Rows, results.size());
+        return SparqlResultSet<T>(std::move(buffer), std::move(results));
+    }
+
+    /**
+     * @brief Parses a SPARQL JSON response into columns instead of row objects.
+     * The result holds a synthesized struct-of-arrays (see ColumnsFor<T>): numeric members become
+     * contiguous vectors, strings a packed character column, and each column has a validity
+     * bitmap marking rows whose OPTIONAL binding was missing. Column scans are cache-friendly
+     * and there is no per-row std::string.
+     * @tparam T The struct describing the result columns.
+     * @param rawJson The raw JSON string returned by the SPARQL endpoint.
+     * @param errors Optional side channel receiving every value that failed to decode (stored as null).
+     * @return ColumnarResult<T> Columns of equal length, one per member of T.
+     */
+    template <typename T>
+    static ColumnarResult<T> parseJsonResponseColumnar(std::string_view rawJson, std::vector<FieldError>* errors = nullptr) {
+        static_assert(!reflection_impl::hasViewMembers<T>(), "std::string_view columns would dangle; use std::string");
+        static_assert(!reflection_impl::hasArrayMembers<T>(), "C array columns are not supported; use std::array");
+        using Dispatch = reflection_impl::MemberDispatch<T>;
+        using Appenders = reflection_impl::ColumnAppenders<T>;
+
+        ColumnarResult<T> result;
+        DecodeContext context{ .errors = errors };
+        Metrics::Stopwatch watch;
+
+        auto rows = MiniSparqlParser::extractBindingViews(rawJson);
+        watch.lap(Metrics::Phase::BindingsExtraction);
+        Appenders::reserveAll(result.columns, rows.size());
+        watch.lap(Metrics::Phase::Materialization);
+
+        std::array<bool, Dispatch::count> seen{};
+        for (std::string_view rowJson : rows) {
+            seen.fill(false);
+            context.row = result.rowCount++;
+            MiniSparqlParser::forEachBinding(rowJson, [&](std::string_view name, const MiniSparqlParser::StringToken& value) {
+                const int index = Dispatch::indexOf(name);
+                if (index >= 0 && !seen[index]) {
+                    // Empty text is skipped by decodeRow too, so it reads as unbound
+                    if (value.text.empty()) Appenders::nulls[index](result.columns);
+                    else Appenders::values[index](result.columns, value, context);
+                    seen[index] = true;
+                }
+            });
+
+            // Keep every column the same length: unbound members become nulls
+            for (std::size_t i = 0; i < Dispatch::count; ++i) {
+                if (!seen[i]) Appenders::nulls[i](result.columns);
+            }
+        }
+        watch.lap(Metrics::Phase::MemberDecode);
+        Metrics::add(Metrics::Counter::Rows, result.rowCount);
+        return result;
+    }
+
+    /**
+     * @brief Fetches @p url and decodes rows while the body is still downloading.
+     * Parsing overlaps the transfer and memory stays flat regardless of result size:
+     * each row is decoded and handed to @p onItem as soon as its closing brace arrives.
+     * @tparam T The target struct type to populate.
+     * @param onItem Called with every decoded row. If it returns bool, false stops the transfer.
+     * @param rowCount Optional out-parameter receiving the number of rows delivered.
+     * @return true if the transfer completed or was stopped by @p onItem.
+     */
+    template <typename T, typename F>
+        requires std::invocable<F&, T&&>
+    static bool streamQuery(NetworkClient& client, const std::string& url, F&& onItem, size_t* rowCount = nullptr) {
+        BindingsStreamParser parser([&](std::string_view rowJson) {
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, T&&>, bool>) {
+                return onItem(parseRow<T>(rowJson));
+            } else {
+                onItem(parseRow<T>(rowJson));
+                return true;
+            }
+        });
+
+        bool ok = client.performGetStreaming(url, [&](std::string_view chunk) {
+            return parser.feed(chunk);
+        });
+
+        if (rowCount) *rowCount = parser.rowCount();
+        return ok;
+    }
+
     /**
      * @brief Executes a simple query where the SELECT clause is generated automatically via Reflection.
      * Use this for straightforward "SELECT * WHERE {...}" scenarios.
      * Moved from main.cpp to keep application logic clean.
+     * @param endpoint SPARQL endpoint to query (e.g. a local mock server).
      */
     template <typename T>
-    static void executeSimpleQueryScenario(std::string_view title, std::string_view whereClause, int limit) {
+    static void executeSimpleQueryScenario(std::string_view title, std::string_view whereClause, int limit,
+                                           std::string_view endpoint = kDefaultEndpoint) {
+        executeSimpleQueryScenario<T>(title, whereClause, limit, [endpoint](const std::string& query) {
+            NetworkClient client;
+            return client.performGet(buildQueryUrl(endpoint, query));
+        });
+    }
+
+    /**
+     * @brief Same scenario with the response body fetched by @p fetchBody(query), e.g. through an
+     * EndpointRouter spreading the queries over several mirrors. An empty body counts as a failure.
+     */
+    template <typename T, typename Fetch>
+        requires std::invocable<Fetch&, const std::string&>
+    static void executeSimpleQueryScenario(std::string_view title, std::string_view whereClause, int limit, Fetch&& fetchBody) {
         std::println("\n========================================");
         std::println("TASK: {}", title);
         std::println("========================================");
@@ -282,11 +1707,8 @@ public:
         std::println("[1] Generated SPARQL:\n{}", query);
 
         // 2. Send & Receive
-        NetworkClient client;
-        std::string url = "https://query.wikidata.org/sparql?query=" + client.urlEncode(query);
-        
         std::print("[2] Sending request... ");
-        std::string json = client.performGet(url);
+        std::string json = fetchBody(query);
 
         if (json.empty()) {
             std::println("Failed! (Empty response)");
@@ -297,29 +1719,42 @@ public:
         // 3. Parse & Print
         auto results = parseJsonResponse<T>(json);
         std::println("[3] Parsed {} items:", results.size());
+        std::string output;
         for (const auto& item : results) {
-            printStruct(item);
+            formatStruct(output, item);
         }
+        std::print("{}", output);
     }
 
     /**
      * @brief Executes a raw, manually written SPARQL query but uses Reflection for parsing results.
      * Use this for COMPLEX scenarios (Aggregations, Grouping, Subqueries).
      * Moved from main.cpp to keep application logic clean.
+     * @param endpoint SPARQL endpoint to query (e.g. a local mock server).
      */
     template <typename T>
-    static void executeRawQueryScenario(std::string_view title, const std::string& fullQuery) {
+    static void executeRawQueryScenario(std::string_view title, const std::string& fullQuery,
+                                        std::string_view endpoint = kDefaultEndpoint) {
+        executeRawQueryScenario<T>(title, fullQuery, [endpoint](const std::string& query) {
+            NetworkClient client;
+            return client.performGet(buildQueryUrl(endpoint, query));
+        });
+    }
+
+    /**
+     * @brief Same scenario with the response body fetched by @p fetchBody(query).
+     */
+    template <typename T, typename Fetch>
+        requires std::invocable<Fetch&, const std::string&>
+    static void executeRawQueryScenario(std::string_view title, const std::string& fullQuery, Fetch&& fetchBody) {
         std::println("\n========================================");
         std::println("TASK: {}", title);
         std::println("========================================");
 
         std::println("[1] Using Manual SPARQL:\n{}", fullQuery);
 
-        NetworkClient client;
-        std::string url = "https://query.wikidata.org/sparql?query=" + client.urlEncode(fullQuery);
-        
         std::print("[2] Sending request... ");
-        std::string json = client.performGet(url);
+        std::string json = fetchBody(fullQuery);
 
         if (json.empty()) {
             std::println("Failed! (Empty response)");
@@ -330,8 +1765,31 @@ public:
         // The Magic: Even though the query was manual, we still parse it automatically!
         auto results = parseJsonResponse<T>(json);
         std::println("[3] Parsed {} items:", results.size());
+        std::string output;
         for (const auto& item : results) {
-            printStruct(item);
+            formatStruct(output, item);
         }
+        std::print("{}", output);
+    }
+
+private:
+    /**
+     * @brief Single-pass row decoder shared by the parsing entry points.
+     * Each bound variable is routed through the compile-time dispatch table straight to its member.
+     */
+    template <typename T>
+    static T decodeRow(std::string_view rowJson, DecodeContext& context) {
+        using Dispatch = reflection_impl::MemberDispatch<T>;
+        constexpr auto& setters = reflection_impl::MemberSetters<T>::table;
+
+        T item{}; // Value initialization (important for ints to be 0)
+
+        MiniSparqlParser::forEachBinding(rowJson, [&](std::string_view name, const MiniSparqlParser::StringToken& value) {
+            const int index = Dispatch::indexOf(name);
+            if (index >= 0 && !value.text.empty()) {
+                setters[index](item, value, context);
+            }
+        });
+        return item;
     }
 };
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Interned.hpp"
+#include "LiteralDecoder.hpp"
+#include "SPARQReflector.hpp"
+
+namespace reflection_impl {
+    /// Order-sensitive combination of a running hash with one more value (SplitMix64 finalizer).
+    constexpr std::uint64_t mixHash(std::uint64_t hash, std::uint64_t value) {
+        std::uint64_t z = value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    template <typename T>
+    std::uint64_t hashMembers(std::uint64_t hash, const T& item);
+
+    /**
+     * @brief Folds one member value into @p hash. Hashes depend only on the values (text is
+     * hashed by content, Interned by its text, -0.0 as 0.0), so they are stable across runs.
+     */
+    template <typename V>
+    std::uint64_t hashValue(std::uint64_t hash, const V& value) {
+        if constexpr (LiteralDecoder::isSpecializationOf<V, ^^Interned>()) {
+            return mixHash(hash, nameHash(value.view(), 0));
+        }
+        else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+            return mixHash(hash, nameHash(std::string_view(value), 0));
+        }
+        else if constexpr (LiteralDecoder::isOptional<V>) {
+            return value ? hashValue(mixHash(hash, 1), *value) : mixHash(hash, 0);
+        }
+        else if constexpr (isChildGroup<V>()) {
+            hash = mixHash(hash, value.size());
+            for (const auto& child : value) hash = hashMembers(hash, child);
+            return hash;
+        }
+        else if constexpr (LiteralDecoder::isCharBuffer<V>()) {
+            return mixHash(hash, nameHash(LiteralDecoder::bufferText(value), 0));
+        }
+        else if constexpr (LiteralDecoder::isSystemTimePoint<V>()) {
+            return mixHash(hash, static_cast<std::uint64_t>(value.time_since_epoch().count()));
+        }
+        else if constexpr (std::is_enum_v<V>) {
+            return mixHash(hash, static_cast<std::uint64_t>(std::to_underlying(value)));
+        }
+        else if constexpr (std::is_floating_point_v<V>) {
+            const double normalized = value == 0 ? 0.0 : std::isnan(value) ? std::nan("") : static_cast<double>(value);
+            return mixHash(hash, std::bit_cast<std::uint64_t>(normalized));
+        }
+        else {
+            static_assert(std::is_integral_v<V>, "Unsupported member type for row hashing");
+            return mixHash(hash, static_cast<std::uint64_t>(value));
+        }
+    }
+
+    template <typename T>
+    std::uint64_t hashMembers(std::uint64_t hash, const T& item) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((hash = hashValue(hash, item.[:MemberDispatch<T>::members[I]:])), ...);
+        }(std::make_index_sequence<MemberDispatch<T>::count>{});
+        return hash;
+    }
+}
+
+/**
+ * @brief Turns repeated runs of the same query into change sets.
+ * Each row gets a key hash over @p KeyMembers and a row hash over all members of T. apply()
+ * matches the new rows against the previous snapshot by key and returns only the rows that
+ * were inserted, changed or deleted, so downstream work scales with the change instead of
+ * the result. The key members should identify a row uniquely (e.g. the entity IRI); rows
+ * sharing a key are matched in order.
+ * @code
+ * SnapshotDiff<RiverInfo, ^^RiverInfo::riverLabel> rivers;
+ * auto delta = rivers.apply(SparqlReflector::parseJsonResponse<RiverInfo>(json));
+ * @endcode
+ */
+template <typename T, meta::info... KeyMembers>
+class SnapshotDiff {
+    static_assert(sizeof...(KeyMembers) > 0, "SnapshotDiff needs at least one key member");
+    static_assert(((meta::parent_of(KeyMembers) == ^^T) && ...), "Key members must be members of T, e.g. ^^T::item");
+
+public:
+    struct Delta {
+        std::vector<T> inserted;
+        std::vector<T> updated; ///< New versions of rows whose non-key members changed
+        std::vector<T> deleted; ///< Rows of the previous snapshot without a match
+
+        [[nodiscard]] bool empty() const { return inserted.empty() && updated.empty() && deleted.empty(); }
+        [[nodiscard]] size_t size() const { return inserted.size() + updated.size() + deleted.size(); }
+    };
+
+    static std::uint64_t keyHash(const T& row) {
+        std::uint64_t hash = 0;
+        ((hash = reflection_impl::hashValue(hash, row.[:KeyMembers:])), ...);
+        return hash;
+    }
+
+    /// Hash of every member; equal rows always hash equal, and a change is missed only on a
+    /// 64-bit collision.
+    static std::uint64_t rowHash(const T& row) {
+        return reflection_impl::hashMembers(0, row);
+    }
+
+    /**
+     * @brief Diffs @p rows against the current snapshot, then makes them the snapshot.
+     * The first call reports every row as inserted.
+     */
+    Delta apply(std::vector<T> rows) {
+        Delta delta;
+        std::vector<std::uint64_t> hashes(rows.size());
+        std::unordered_multimap<std::uint64_t, size_t> keys;
+        keys.reserve(rows.size());
+        std::vector<bool> matched(previous.size());
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const T& row = rows[i];
+            const std::uint64_t key = keyHash(row);
+            hashes[i] = rowHash(row);
+            keys.emplace(key, i);
+
+            const size_t match = find(key, row, matched);
+            if (match == kNone) {
+                delta.inserted.push_back(row);
+            } else {
+                matched[match] = true;
+                if (previousHashes[match] != hashes[i]) delta.updated.push_back(row);
+            }
+        }
+        for (size_t j = 0; j < previous.size(); ++j) {
+            if (!matched[j]) delta.deleted.push_back(std::move(previous[j]));
+        }
+
+        previous = std::move(rows);
+        previousHashes = std::move(hashes);
+        previousKeys = std::move(keys);
+        return delta;
+    }
+
+    /// Rows of the last apply().
+    [[nodiscard]] const std::vector<T>& snapshot() const { return previous; }
+
+private:
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    static bool sameKey(const T& a, const T& b) {
+        return ((a.[:KeyMembers:] == b.[:KeyMembers:]) && ...);
+    }
+
+    // First unmatched row of the previous snapshot with the same key
+    size_t find(std::uint64_t key, const T& row, const std::vector<bool>& matched) const {
+        auto [it, end] = previousKeys.equal_range(key);
+        size_t best = kNone;
+        for (; it != end; ++it) {
+            const size_t index = it->second;
+            if (!matched[index] && index < best && sameKey(previous[index], row)) best = index;
+        }
+        return best;
+    }
+
+    std::vector<T> previous;
+    std::vector<std::uint64_t> previousHashes;
+    std::unordered_multimap<std::uint64_t, size_t> previousKeys;
+};
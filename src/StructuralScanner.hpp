@@ -0,0 +1,210 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SPARQ_SCANNER_X86 1
+#endif
+
+/**
+ * @brief Vectorized structural scanner for JSON documents (the "stage 1" of simdjson-style parsers).
+ * The input is classified in 64-byte blocks into bitmasks of quotes, backslashes and structural
+ * characters ({ } [ ] : ,). Escapes are resolved and string interiors are masked out with a
+ * prefix-XOR, so only real structure is reported: braces or quotes inside literals never are.
+ * Classification runs on AVX2 or SSE4.2 when the CPU supports it (checked once at runtime),
+ * with a portable scalar fallback.
+ * The index currently drives row splitting only (MiniSparqlParser::forEachBindingRow). Walking
+ * the bindings inside a row (forEachBinding, extractValue) and the streaming BindingsStreamParser
+ * still scan with memchr-style searches.
+ */
+class StructuralScanner {
+public:
+    enum class Backend { Scalar, SSE42, AVX2 };
+
+    /// Raw per-block classification: bit i describes byte i of the 64-byte block.
+    struct BlockMasks {
+        uint64_t quote = 0;
+        uint64_t backslash = 0;
+        uint64_t op = 0; ///< { } [ ] : ,
+    };
+
+    /// @return The best backend supported by the running CPU.
+    static Backend detectBackend() {
+#if SPARQ_SCANNER_X86 && (defined(__GNUC__) || defined(__clang__))
+        if (__builtin_cpu_supports("avx2")) return Backend::AVX2;
+        if (__builtin_cpu_supports("sse4.2")) return Backend::SSE42;
+#endif
+        return Backend::Scalar;
+    }
+
+    /// @return The backend used by scan() when none is given (detected once per process).
+    static Backend activeBackend() {
+        static const Backend backend = detectBackend();
+        return backend;
+    }
+
+    static constexpr std::string_view backendName(Backend backend) {
+        switch (backend) {
+            case Backend::AVX2:  return "avx2";
+            case Backend::SSE42: return "sse4.2";
+            default:             return "scalar";
+        }
+    }
+
+    /**
+     * @brief Reports every structural character and every unescaped quote outside of strings.
+     * For each string literal both its opening and closing quote are reported, so consecutive
+     * quote positions delimit the literal.
+     * @param json The document to scan.
+     * @param onStructural Called as onStructural(size_t pos, char c); return false to stop early.
+     * @param backend Classification backend (defaults to the detected one).
+     */
+    template <typename F>
+    static void scan(std::string_view json, F&& onStructural, Backend backend = activeBackend()) {
+        const ClassifyFn classify = classifierFor(backend);
+
+        uint64_t prevEscaped = 0;  // 1 if the previous block ended in an unfinished escape
+        uint64_t prevInString = 0; // All ones if the previous block ended inside a string
+
+        for (size_t blockStart = 0; blockStart < json.size(); blockStart += 64) {
+            BlockMasks masks;
+            if (json.size() - blockStart >= 64) {
+                masks = classify(json.data() + blockStart);
+            } else {
+                // Pad the tail with spaces so it classifies like a full block
+                char tail[64];
+                std::memset(tail, ' ', sizeof(tail));
+                std::memcpy(tail, json.data() + blockStart, json.size() - blockStart);
+                masks = classify(tail);
+            }
+
+            const uint64_t escaped = escapedMask(masks.backslash, prevEscaped);
+            const uint64_t quotes = masks.quote & ~escaped;
+
+            // Bits inside a string, including the opening quote but not the closing one
+            const uint64_t inString = prefixXor(quotes) ^ prevInString;
+            prevInString = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+
+            uint64_t structural = (masks.op & ~inString) | quotes;
+            while (structural) {
+                const size_t pos = blockStart + static_cast<size_t>(std::countr_zero(structural));
+                if (!onStructural(pos, json[pos])) return;
+                structural &= structural - 1;
+            }
+        }
+    }
+
+    /// Scalar reference classification of one 64-byte block.
+    static BlockMasks classifyScalar(const char* block) {
+        BlockMasks masks;
+        for (int i = 0; i < 64; ++i) {
+            const uint64_t bit = uint64_t{1} << i;
+            switch (block[i]) {
+                case '"':  masks.quote |= bit; break;
+                case '\\': masks.backslash |= bit; break;
+                case '{': case '}': case '[': case ']': case ':': case ',':
+                    masks.op |= bit;
+                    break;
+                default: break;
+            }
+        }
+        return masks;
+    }
+
+#if SPARQ_SCANNER_X86 && (defined(__GNUC__) || defined(__clang__))
+    __attribute__((target("avx2")))
+    static BlockMasks classifyAVX2(const char* block) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+        BlockMasks masks;
+        masks.quote = matchAVX2(lo, hi, '"');
+        masks.backslash = matchAVX2(lo, hi, '\\');
+        masks.op = matchAVX2(lo, hi, '{') | matchAVX2(lo, hi, '}') | matchAVX2(lo, hi, '[') |
+                   matchAVX2(lo, hi, ']') | matchAVX2(lo, hi, ':') | matchAVX2(lo, hi, ',');
+        return masks;
+    }
+
+    __attribute__((target("sse4.2")))
+    static BlockMasks classifySSE42(const char* block) {
+        __m128i lanes[4];
+        for (int i = 0; i < 4; ++i) {
+            lanes[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        }
+
+        BlockMasks masks;
+        masks.quote = matchSSE42(lanes, '"');
+        masks.backslash = matchSSE42(lanes, '\\');
+        masks.op = matchSSE42(lanes, '{') | matchSSE42(lanes, '}') | matchSSE42(lanes, '[') |
+                   matchSSE42(lanes, ']') | matchSSE42(lanes, ':') | matchSSE42(lanes, ',');
+        return masks;
+    }
+#endif
+
+private:
+#if SPARQ_SCANNER_X86 && (defined(__GNUC__) || defined(__clang__))
+    __attribute__((target("avx2")))
+    static uint64_t matchAVX2(__m256i lo, __m256i hi, char c) {
+        const __m256i needle = _mm256_set1_epi8(c);
+        const uint64_t l = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+        const uint64_t h = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+        return l | (h << 32);
+    }
+
+    __attribute__((target("sse4.2")))
+    static uint64_t matchSSE42(const __m128i* lanes, char c) {
+        const __m128i needle = _mm_set1_epi8(c);
+        uint64_t mask = 0;
+        for (int i = 0; i < 4; ++i) {
+            mask |= static_cast<uint64_t>(static_cast<uint16_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(lanes[i], needle)))) << (i * 16);
+        }
+        return mask;
+    }
+#endif
+
+    using ClassifyFn = BlockMasks (*)(const char*);
+
+    static ClassifyFn classifierFor(Backend backend) {
+#if SPARQ_SCANNER_X86 && (defined(__GNUC__) || defined(__clang__))
+        if (backend == Backend::AVX2) return classifyAVX2;
+        if (backend == Backend::SSE42) return classifySSE42;
+#endif
+        (void)backend;
+        return classifyScalar;
+    }
+
+    /**
+     * @brief Marks the characters escaped by a backslash (branchless, as in simdjson).
+     * Runs of backslashes escape each other pairwise; only odd positions within a run escape
+     * the following character. @p prevEscaped carries an unfinished escape across blocks.
+     */
+    static uint64_t escapedMask(uint64_t backslash, uint64_t& prevEscaped) {
+        constexpr uint64_t evenBits = 0x5555555555555555ull;
+
+        backslash &= ~prevEscaped; // An escaped backslash does not start a new escape
+        const uint64_t followsEscape = (backslash << 1) | prevEscaped;
+
+        const uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+        const uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+        prevEscaped = sequencesStartingOnEvenBits < backslash ? 1 : 0; // Carry out of bit 63
+
+        const uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+        return (evenBits ^ invertMask) & followsEscape;
+    }
+
+    /// Bit i of the result is the XOR of bits 0..i of @p x.
+    static constexpr uint64_t prefixXor(uint64_t x) {
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+    }
+};
@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
 #include <print>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "EndpointRouter.hpp"
 #include "SPARQReflector.hpp"
 
 // =============================================================================
@@ -9,12 +15,12 @@
 
 struct ProgrammingLanguage {
     std::string langLabel;
-    std::string creatorLabel;
+    Interned<> creatorLabel; // Few distinct creators across many rows: dictionary-encoded
 };
 
 struct SpaceTelescope {
     std::string telescopeLabel;
-    std::string launchDate;
+    std::optional<std::chrono::sys_seconds> launchDate; // xsd:dateTime, unbound when unknown
 };
 
 struct RiverInfo {
@@ -35,6 +41,28 @@ struct AstronautStats {
 int main() {
     std::println("--- SparqReflect: C++26 Semantic Web Client ---");
 
+    // SPARQ_ENDPOINT points the scenarios elsewhere, e.g. at tools/mock_sparql_server
+    const char* endpointOverride = std::getenv("SPARQ_ENDPOINT");
+    const std::string_view endpoint = endpointOverride ? endpointOverride : SparqlReflector::kDefaultEndpoint;
+
+    // SPARQ_ENDPOINTS spreads the scenarios over equivalent mirrors, comma-separated, e.g.
+    // "https://query.wikidata.org/sparql,http://localhost:7001/sparql" (latency-routed, hedged, with failover)
+    std::vector<std::string> mirrors;
+    if (const char* list = std::getenv("SPARQ_ENDPOINTS")) {
+        for (std::string_view rest = list; !rest.empty();) {
+            const size_t comma = std::min(rest.find(','), rest.size());
+            if (comma > 0) mirrors.emplace_back(rest.substr(0, comma));
+            rest.remove_prefix(std::min(comma + 1, rest.size()));
+        }
+    }
+    if (mirrors.empty()) mirrors.emplace_back(endpoint);
+
+    EndpointRouter router(std::move(mirrors));
+    auto fetchBody = [&router](const std::string& query) {
+        NetworkClient::HttpResponse response = router.fetch(query);
+        return response.ok() ? std::move(response.body) : std::string();
+    };
+
     // ---------------------------------------------------------
     // TASK 3: Basic Queries (Automatic Generation)
     // ---------------------------------------------------------
@@ -49,7 +77,7 @@ int main() {
             FILTER(LANG(?langLabel) = 'en' && LANG(?creatorLabel) = 'en')
         }
     )";
-    SparqlReflector::executeSimpleQueryScenario<ProgrammingLanguage>("Basic Query 1: Programming Languages", where1, 5);
+    SparqlReflector::executeSimpleQueryScenario<ProgrammingLanguage>("Basic Query 1: Programming Languages", where1, 5, fetchBody);
 
     // Scenario 2: Space Telescopes
     // Fixed: Added OPTIONAL for launch date to ensure results even if data is missing.
@@ -61,7 +89,7 @@ int main() {
             OPTIONAL { ?telescope wdt:P619 ?launchDate. }
         }
     )";
-    SparqlReflector::executeSimpleQueryScenario<SpaceTelescope>("Basic Query 2: Space Telescopes", where2, 5);
+    SparqlReflector::executeSimpleQueryScenario<SpaceTelescope>("Basic Query 2: Space Telescopes", where2, 5, fetchBody);
 
     // Scenario 3: Rivers (Optional Data)
     std::string where3 = R"(
@@ -72,7 +100,7 @@ int main() {
             FILTER(LANG(?riverLabel) = 'en')
         }
     )";
-    SparqlReflector::executeSimpleQueryScenario<RiverInfo>("Feature Query: Rivers (Optional Length)", where3, 5);
+    SparqlReflector::executeSimpleQueryScenario<RiverInfo>("Feature Query: Rivers (Optional Length)", where3, 5, fetchBody);
 
     // ---------------------------------------------------------
     // TASK 4: Advanced Query (Grouping & Ranking)
@@ -92,7 +120,12 @@ int main() {
         LIMIT 10
     )";
 
-    SparqlReflector::executeRawQueryScenario<AstronautStats>("Advanced Query: Astronauts per Country", query4);
+    SparqlReflector::executeRawQueryScenario<AstronautStats>("Advanced Query: Astronauts per Country", query4, fetchBody);
+
+    // Per-phase timings and counters of the scenarios above (SPARQ_METRICS_FORMAT=prometheus|json)
+    if (const char* format = std::getenv("SPARQ_METRICS_FORMAT")) {
+        std::println("\n{}", std::string_view(format) == "json" ? Metrics::toJson() : Metrics::toPrometheus());
+    }
 
     return 0;
 }
\ No newline at end of file
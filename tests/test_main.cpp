@@ -1,9 +1,32 @@
 #include <gtest/gtest.h>
 #include <string>
 #include <vector>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <memory_resource>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 // Include the header directly as CMake handles include directories
 #include "SPARQReflector.hpp"
+#include "BatchLookup.hpp"
+#include "BinarySnapshot.hpp"
+#include "BulkExport.hpp"
+#include "BatchQueryExecutor.hpp"
+#include "EndpointRouter.hpp"
+#include "PagedQuery.hpp"
+#include "QueryCache.hpp"
+#include "RequestScheduler.hpp"
+#include "SnapshotDiff.hpp"
+#include "QueryTemplate.hpp"
+#include "ThreadPool.hpp"
 
 // =============================================================================
 // Test Data Structures
@@ -20,6 +43,65 @@ struct Book {
     int year;
 };
 
+struct River {
+    std::string riverLabel;
+    double length;
+    bool navigable;
+    std::optional<double> discharge;
+};
+
+struct PersonView {
+    std::string_view name;
+    int age;
+};
+
+enum class MissionStatus { Planned, Active, Retired };
+
+struct Mission {
+    std::string name;
+    bool crewed;
+    MissionStatus status;
+    std::chrono::sys_seconds launch;
+    std::optional<int> crewSize;
+    char code[8];
+    std::array<char, 4> agency;
+    double budget;
+};
+
+struct ArenaPerson {
+    std::pmr::string name;
+    int age;
+};
+
+struct LanguageRow {
+    std::string langLabel;
+    Interned<struct CreatorTag> creatorLabel;
+};
+
+struct Creator {
+    std::string creatorLabel;
+};
+
+struct Paradigm {
+    std::string paradigmLabel;
+};
+
+struct LanguageGroup {
+    std::string langLabel;
+    int year;
+    std::vector<Creator> creators;
+    std::vector<Paradigm> paradigms;
+};
+
+struct Planet {
+    std::string planetLabel;
+    std::string discoverer;
+    double mass;
+    double radius;
+    long long moons;
+    std::string atmosphere;
+};
+
 // =============================================================================
 // Reflection Tests
 // =============================================================================
@@ -92,6 +174,909 @@ TEST(ReflectionTest, ParseJsonResponse) {
     EXPECT_EQ(people[1].age, 25);
 }
 
+/**
+ * @brief Verify the streaming tokenizer when the body arrives in arbitrary pieces.
+ * Every row must survive being split at any byte, including braces inside literals.
+ */
+TEST(StreamingTest, ChunkedBindings) {
+    std::string rawJson = R"({
+        "head": { "vars": [ "name", "age" ] },
+        "results": {
+            "bindings": [
+                { "name": { "type": "literal", "value": "Alice {the first}" },
+                  "age": { "type": "literal", "value": "30" } },
+                { "name": { "type": "literal", "value": "Bob" },
+                  "age": { "type": "literal", "value": "25" } }
+            ]
+        }
+    })";
+
+    for (size_t chunkSize : {1uz, 7uz, rawJson.size()}) {
+        std::vector<Person> people;
+        BindingsStreamParser parser([&](std::string_view rowJson) {
+            people.push_back(SparqlReflector::parseRow<Person>(rowJson));
+            return true;
+        });
+
+        for (size_t pos = 0; pos < rawJson.size(); pos += chunkSize) {
+            ASSERT_TRUE(parser.feed(std::string_view(rawJson).substr(pos, chunkSize)));
+        }
+
+        EXPECT_TRUE(parser.finished());
+        ASSERT_EQ(people.size(), 2) << "chunk size " << chunkSize;
+        EXPECT_EQ(people[0].age, 30);
+        EXPECT_EQ(people[1].name, "Bob");
+    }
+}
+
+/**
+ * @brief Verify the single-pass row decoder.
+ * Variables may come in any order, unknown variables are skipped, and escapes are decoded.
+ */
+TEST(ReflectionTest, SinglePassRowDecoder) {
+    using Dispatch = reflection_impl::MemberDispatch<Planet>;
+    static_assert(Dispatch::indexOf("planetLabel") == 0);
+    static_assert(Dispatch::indexOf("atmosphere") == 5);
+    static_assert(Dispatch::indexOf("planet") == -1);
+
+    std::string rowJson = R"({
+        "moons": { "type": "literal", "value": "2" },
+        "unused": { "type": "uri", "value": "http://www.wikidata.org/entity/Q111" },
+        "planetLabel": { "xml:lang": "en", "type": "literal", "value": "Mars \"the red\" {planet}" },
+        "radius": { "type": "literal", "value": "3389.5" },
+        "atmosphere": { "type": "literal", "value": "CO\u2082" }
+    })";
+
+    Planet planet = SparqlReflector::parseRow<Planet>(rowJson);
+
+    EXPECT_EQ(planet.planetLabel, "Mars \"the red\" {planet}");
+    EXPECT_EQ(planet.discoverer, "");
+    EXPECT_DOUBLE_EQ(planet.mass, 0.0);
+    EXPECT_DOUBLE_EQ(planet.radius, 3389.5);
+    EXPECT_EQ(planet.moons, 2);
+    EXPECT_EQ(planet.atmosphere, "CO\u2082");
+}
+
+/**
+ * @brief Verify the zero-copy path: string_view members point into the buffer owned by the result.
+ */
+TEST(ReflectionTest, ParseJsonResponseInPlace) {
+    std::string rawJson = R"({
+        "results": { "bindings": [
+            { "name": { "type": "literal", "value": "Alice" }, "age": { "type": "literal", "value": "30" } },
+            { "name": { "type": "literal", "value": "Bob \"Bobby\" Smith" }, "age": { "type": "literal", "value": "25" } }
+        ] }
+    })";
+
+    SparqlResultSet<PersonView> people = SparqlReflector::parseJsonResponseInPlace<PersonView>(std::move(rawJson));
+
+    // Moving the result set must not invalidate the views
+    SparqlResultSet<PersonView> moved = std::move(people);
+    ASSERT_EQ(moved.size(), 2);
+
+    std::string_view buffer = moved.buffer();
+    for (const auto& person : moved) {
+        EXPECT_GE(person.name.data(), buffer.data());
+        EXPECT_LE(person.name.data() + person.name.size(), buffer.data() + buffer.size());
+    }
+
+    EXPECT_EQ(moved[0].name, "Alice");
+    EXPECT_EQ(moved[0].age, 30);
+    EXPECT_EQ(moved[1].name, "Bob \"Bobby\" Smith");
+    EXPECT_EQ(moved[1].age, 25);
+}
+
+/**
+ * @brief Verify that structure inside string literals is ignored by every scanner backend.
+ */
+TEST(ScannerTest, LiteralsDoNotBreakStructure) {
+    std::string rawJson = R"({
+        "head": { "vars": [ "bindings", "name", "age" ] },
+        "results": { "bindings": [
+            { "name": { "type": "literal", "value": "}], \"{[ tricky" }, "age": { "type": "literal", "value": "41" } },
+            { "name": { "type": "literal", "value": "C:\\" }, "age": { "type": "literal", "value": "7" } }
+        ] }
+    })";
+
+    std::vector<size_t> expected;
+    StructuralScanner::scan(rawJson, [&](size_t pos, char) { expected.push_back(pos); return true; },
+                            StructuralScanner::Backend::Scalar);
+
+    for (auto backend : {StructuralScanner::Backend::SSE42, StructuralScanner::Backend::AVX2}) {
+        if (backend > StructuralScanner::detectBackend()) continue;
+        std::vector<size_t> actual;
+        StructuralScanner::scan(rawJson, [&](size_t pos, char) { actual.push_back(pos); return true; }, backend);
+        EXPECT_EQ(actual, expected) << StructuralScanner::backendName(backend);
+    }
+
+    std::vector<Person> people = SparqlReflector::parseJsonResponse<Person>(rawJson);
+    ASSERT_EQ(people.size(), 2);
+    EXPECT_EQ(people[0].name, "}], \"{[ tricky");
+    EXPECT_EQ(people[0].age, 41);
+    EXPECT_EQ(people[1].name, "C:\\");
+    EXPECT_EQ(people[1].age, 7);
+}
+
+/**
+ * @brief Verify that easy handles are pooled across client instances and URL encoding needs no handle.
+ */
+TEST(NetworkTest, HandlePoolReuse) {
+    EXPECT_EQ(NetworkClient::urlEncode("SELECT ?x"), "SELECT%20%3Fx");
+
+    CURL* first = nullptr;
+    {
+        NetworkClient client;
+        first = client.acquireHandle();
+        ASSERT_NE(first, nullptr);
+        client.releaseHandle(first);
+    }
+
+    NetworkClient other;
+    CURL* second = other.acquireHandle();
+    EXPECT_EQ(second, first) << "Released handle should be reused by the next request";
+    other.releaseHandle(second);
+}
+
+/**
+ * @brief Verify that the worker pool runs every task and hands back results and exceptions.
+ */
+TEST(ConcurrencyTest, ThreadPoolResults) {
+    ThreadPool pool(4);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(results[i].get(), i * i);
+    }
+
+    auto failing = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+}
+
+/**
+ * @brief Verify that a batch mixing result types completes every future, even when the endpoint is down.
+ * Port 1 on localhost refuses connections, so this runs offline.
+ */
+TEST(ConcurrencyTest, BatchExecutorReportsTransportErrors) {
+    BatchQueryExecutor::Options options;
+    options.endpoint = "http://127.0.0.1:1/sparql";
+    options.maxInFlight = 2;
+    BatchQueryExecutor executor(options);
+
+    auto people = executor.submitSimple<Person>("{ ?name ?p ?age }", 5);
+    auto books = executor.submitSimple<Book>("{ ?title ?p ?author }", 5);
+    auto more = executor.submit<Person>("SELECT ?name ?age WHERE { ?name ?p ?age }");
+
+    EXPECT_THROW(people.get(), std::runtime_error);
+    EXPECT_THROW(books.get(), std::runtime_error);
+    EXPECT_THROW(more.get(), std::runtime_error);
+}
+
+/**
+ * @brief Verify query normalization and both cache tiers without touching the network.
+ */
+TEST(CacheTest, NormalizeAndTiers) {
+    EXPECT_EQ(QueryCache::normalizeQuery("SELECT  ?x\n  WHERE { ?x <http://x.org/a#b>  \"a  b\" } # note\n LIMIT 5"),
+              "SELECT ?x WHERE { ?x <http://x.org/a#b> \"a  b\" } LIMIT 5");
+    EXPECT_EQ(QueryCache::makeKey<Person>("http://e", "SELECT ?x"), QueryCache::makeKey<Person>("http://e", " SELECT\t?x "));
+    EXPECT_NE(QueryCache::makeKey<Person>("http://e", "SELECT ?x"), QueryCache::makeKey<Book>("http://e", "SELECT ?x"));
+    struct Contact { std::string name; int age; }; // Same layout as Person, still a different result type
+    EXPECT_NE(QueryCache::makeKey<Person>("http://e", "SELECT ?x"), QueryCache::makeKey<Contact>("http://e", "SELECT ?x"));
+
+    QueryCache::Options options;
+    options.memoryBytes = 100;
+    options.directory = std::filesystem::temp_directory_path() / "sparqreflect_cache_test";
+    QueryCache cache(options);
+    cache.clear();
+
+    // Memory tier: least recently used entries go first once the budget is exceeded
+    cache.storeMemory("a", std::make_shared<const int>(1), 60);
+    cache.storeMemory("b", std::make_shared<const int>(2), 30);
+    EXPECT_NE(cache.lookupMemory<int>("a"), nullptr);
+    cache.storeMemory("c", std::make_shared<const int>(3), 30);
+    EXPECT_NE(cache.lookupMemory<int>("a"), nullptr);
+    EXPECT_EQ(cache.lookupMemory<int>("b"), nullptr);
+    EXPECT_NE(cache.lookupMemory<int>("c"), nullptr);
+    EXPECT_EQ(cache.lookupMemory<long>("c"), nullptr) << "Values only come back as the type they were stored as";
+
+    // Disk tier: bodies round-trip through mmap and are keyed exactly
+    cache.storeDisk("key-1", "{ \"results\": { \"bindings\": [] } }");
+    auto mapped = cache.lookupDisk("key-1");
+    ASSERT_TRUE(mapped.has_value());
+    EXPECT_EQ(mapped->body(), "{ \"results\": { \"bindings\": [] } }");
+    EXPECT_FALSE(cache.lookupDisk("key-2").has_value());
+
+    cache.clear();
+    EXPECT_FALSE(cache.lookupDisk("key-1").has_value());
+}
+
+/**
+ * @brief Verify the columnar parse: contiguous columns, packed strings and validity bits for OPTIONALs.
+ */
+TEST(ReflectionTest, ParseJsonResponseColumnar) {
+    std::string rawJson = R"({
+        "results": { "bindings": [
+            { "riverLabel": { "type": "literal", "value": "Nile" }, "length": { "type": "literal", "value": "6650" },
+              "navigable": { "type": "literal", "value": "true" }, "discharge": { "type": "literal", "value": "2830" } },
+            { "riverLabel": { "type": "literal", "value": "Th\u00e9mes" }, "navigable": { "type": "literal", "value": "false" } },
+            { "length": { "type": "literal", "value": "6400.5" }, "riverLabel": { "type": "literal", "value": "Amazon" } },
+            { "riverLabel": { "type": "literal", "value": "" }, "length": { "type": "literal", "value": "" } }
+        ] }
+    })";
+
+    ColumnarResult<River> result = SparqlReflector::parseJsonResponseColumnar<River>(rawJson);
+
+    ASSERT_EQ(result.rowCount, 4);
+    const Column<double>& length = result.columns.length;
+    const Column<std::string>& label = result.columns.riverLabel;
+    ASSERT_EQ(length.size(), 4);
+    ASSERT_EQ(label.size(), 4);
+
+    EXPECT_EQ(label[0], "Nile");
+    EXPECT_EQ(label[1], "Th\u00e9mes");
+    EXPECT_EQ(label[2], "Amazon");
+    EXPECT_FALSE(label.isValid(3)) << "Empty values read as unbound, like in the row parse";
+    EXPECT_EQ(label.validity.countValid(), 3);
+
+    EXPECT_DOUBLE_EQ(length[0], 6650.0);
+    EXPECT_FALSE(length.isValid(1));
+    EXPECT_DOUBLE_EQ(length[1], 0.0);
+    EXPECT_DOUBLE_EQ(length[2], 6400.5);
+    EXPECT_FALSE(length.isValid(3));
+    EXPECT_EQ(length.validity.countValid(), 2);
+
+    const Column<bool>& navigable = result.columns.navigable;
+    ASSERT_EQ(navigable.size(), 4);
+    EXPECT_TRUE(navigable[0]);
+    EXPECT_TRUE(navigable.isValid(1));
+    EXPECT_FALSE(navigable[1]);
+    EXPECT_FALSE(navigable.isValid(2));
+    EXPECT_EQ(navigable.validity.countValid(), 2);
+
+    // Optional members get a plain column of their value type; the bitmap is the only null marker
+    const Column<double>& discharge = result.columns.discharge;
+    ASSERT_EQ(discharge.size(), 4);
+    EXPECT_DOUBLE_EQ(discharge[0], 2830.0);
+    EXPECT_EQ(discharge.validity.countValid(), 1);
+}
+
+/**
+ * @brief Verify that the parallel parser produces exactly the sequential result, in order.
+ */
+TEST(ConcurrencyTest, ParallelParseMatchesSequential) {
+    std::string rawJson = R"({ "head": { "vars": [ "title", "author", "year" ] }, "results": { "bindings": [)";
+    for (int i = 0; i < 20000; ++i) {
+        if (i) rawJson += ",";
+        rawJson += std::format(R"({{ "title": {{ "type": "literal", "value": "Book {{{}}}" }}, )"
+                               R"("author": {{ "type": "literal", "value": "Author \"{}\"" }}, )"
+                               R"("year": {{ "type": "literal", "value": "{}" }} }})", i, i % 97, 1900 + i % 120);
+    }
+    rawJson += "] } }";
+
+    std::vector<Book> sequential = SparqlReflector::parseJsonResponse<Book>(rawJson);
+
+    ThreadPool pool(4);
+    std::vector<Book> parallel = SparqlReflector::parseJsonResponseParallel<Book>(rawJson, pool, 256);
+
+    ASSERT_EQ(sequential.size(), 20000);
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (size_t i = 0; i < sequential.size(); ++i) {
+        EXPECT_EQ(parallel[i].title, sequential[i].title);
+        EXPECT_EQ(parallel[i].author, sequential[i].author);
+        EXPECT_EQ(parallel[i].year, sequential[i].year);
+    }
+    EXPECT_EQ(parallel[12345].title, "Book {12345}");
+
+    // Called from the pool's only worker: the caller decodes the chunks itself instead of waiting on them
+    ThreadPool single(1);
+    auto nested = single.submit([&] { return SparqlReflector::parseJsonResponseParallel<Book>(rawJson, single, 256); });
+    ASSERT_EQ(nested.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    EXPECT_EQ(nested.get().size(), sequential.size());
+}
+
+/**
+ * @brief Verify typed literal decoding and that failures are reported instead of swallowed.
+ */
+TEST(ReflectionTest, TypedLiteralsAndFieldErrors) {
+    std::string json = R"({ "results": { "bindings": [
+        { "name": { "type": "literal", "value": "Hubble" },
+          "crewed": { "type": "literal", "value": "false" },
+          "status": { "type": "literal", "value": "Active" },
+          "launch": { "type": "literal", "value": "1990-04-24T12:33:51.5Z" },
+          "code": { "type": "literal", "value": "HST" },
+          "agency": { "type": "literal", "value": "NASA" },
+          "budget": { "type": "literal", "value": "+4.7E9" } },
+        { "name": { "type": "literal", "value": "Apollo 11" },
+          "crewed": { "type": "literal", "value": "1" },
+          "status": { "type": "literal", "value": "2" },
+          "launch": { "type": "literal", "value": "1969-07-16T09:32:00-04:00" },
+          "crewSize": { "type": "literal", "value": "3" },
+          "code": { "type": "literal", "value": "AS-506" } },
+        { "name": { "type": "literal", "value": "Broken" },
+          "crewed": { "type": "literal", "value": "maybe" },
+          "status": { "type": "literal", "value": "Cancelled" },
+          "launch": { "type": "literal", "value": "1990-13-01" },
+          "crewSize": { "type": "literal", "value": "99999999999" },
+          "code": { "type": "literal", "value": "TOO-LONG-CODE" },
+          "budget": { "type": "literal", "value": "12abc" } }
+    ] } })";
+
+    using namespace std::chrono;
+    std::vector<FieldError> errors;
+    auto missions = SparqlReflector::parseJsonResponse<Mission>(json, &errors);
+    ASSERT_EQ(missions.size(), 3);
+
+    EXPECT_FALSE(missions[0].crewed);
+    EXPECT_EQ(missions[0].status, MissionStatus::Active);
+    EXPECT_EQ(missions[0].launch, sys_days{1990y / April / 24} + 12h + 33min + 51s); // Fraction floored
+    EXPECT_FALSE(missions[0].crewSize.has_value());
+    EXPECT_STREQ(missions[0].code, "HST");
+    EXPECT_EQ(LiteralDecoder::bufferText(missions[0].agency), "NASA");
+    EXPECT_DOUBLE_EQ(missions[0].budget, 4.7e9);
+
+    EXPECT_TRUE(missions[1].crewed);
+    EXPECT_EQ(missions[1].status, MissionStatus::Retired);
+    EXPECT_EQ(missions[1].launch, sys_days{1969y / July / 16} + 13h + 32min); // Offset applied
+    EXPECT_EQ(missions[1].crewSize, 3);
+    EXPECT_STREQ(missions[1].code, "AS-506");
+
+    // Rejected values leave members value-initialized
+    EXPECT_EQ(missions[2].name, "Broken");
+    EXPECT_FALSE(missions[2].crewed);
+    EXPECT_FALSE(missions[2].crewSize.has_value());
+    EXPECT_STREQ(missions[2].code, "");
+    EXPECT_EQ(missions[2].budget, 0.0);
+
+    ASSERT_EQ(errors.size(), 6);
+    for (const auto& error : errors) EXPECT_EQ(error.row, 2);
+    EXPECT_EQ(errors[0].member, "crewed");
+    EXPECT_EQ(errors[0].error, LiteralError::Syntax);
+    EXPECT_EQ(errors[1].member, "status");
+    EXPECT_EQ(errors[1].error, LiteralError::UnknownEnumerator);
+    EXPECT_EQ(errors[2].member, "launch");
+    EXPECT_EQ(errors[2].error, LiteralError::OutOfRange);
+    EXPECT_EQ(errors[3].member, "crewSize");
+    EXPECT_EQ(errors[3].error, LiteralError::OutOfRange);
+    EXPECT_EQ(errors[4].member, "code");
+    EXPECT_EQ(errors[4].value, "TOO-LONG-CODE");
+    EXPECT_EQ(errors[5].member, "budget");
+    EXPECT_EQ(errors[5].error, LiteralError::Syntax);
+}
+
+/**
+ * @brief Verify the TSV and CSV result formats decode to the same rows as JSON.
+ */
+TEST(FormatTest, TsvAndCsvMatchJson) {
+    std::string json = R"({ "results": { "bindings": [
+        { "title": { "type": "literal", "value": "Dune", "xml:lang": "en" },
+          "author": { "type": "uri", "value": "http://www.wikidata.org/entity/Q7934" },
+          "year": { "type": "literal", "datatype": "http://www.w3.org/2001/XMLSchema#integer", "value": "1965" } },
+        { "title": { "type": "literal", "value": "Tab\there, \"quoted\"\nline" },
+          "year": { "type": "literal", "value": "1984" } },
+        { "title": { "type": "literal", "value": "Caf\u00e9 \ud83d\ude00" },
+          "author": { "type": "bnode", "value": "b0" } }
+    ] } })";
+
+    std::string tsv =
+        "?title\t?author\t?year\n"
+        "\"Dune\"@en\t<http://www.wikidata.org/entity/Q7934>\t1965\n"
+        "\"Tab\\there, \\\"quoted\\\"\\nline\"\t\t\"1984\"^^<http://www.w3.org/2001/XMLSchema#integer>\n"
+        "\"Caf\\u00E9 \\U0001F600\"\t_:b0\t\n";
+
+    std::string csv =
+        "title,author,year\r\n"
+        "Dune,http://www.wikidata.org/entity/Q7934,1965\r\n"
+        "\"Tab\there, \"\"quoted\"\"\nline\",,1984\r\n"
+        "Caf\u00e9 \U0001F600,_:b0,\r\n";
+
+    auto fromJson = SparqlReflector::parseResponse<Book>(json, ResultFormat::Json);
+    auto fromTsv = SparqlReflector::parseResponse<Book>(tsv, ResultFormat::Tsv);
+    auto fromCsv = SparqlReflector::parseResponse<Book>(csv, ResultFormat::Csv);
+
+    ASSERT_EQ(fromJson.size(), 3);
+    ASSERT_EQ(fromTsv.size(), 3);
+    ASSERT_EQ(fromCsv.size(), 3);
+    for (size_t i = 0; i < fromJson.size(); ++i) {
+        EXPECT_EQ(fromTsv[i].title, fromJson[i].title) << "TSV row " << i;
+        EXPECT_EQ(fromTsv[i].author, fromJson[i].author) << "TSV row " << i;
+        EXPECT_EQ(fromTsv[i].year, fromJson[i].year) << "TSV row " << i;
+        EXPECT_EQ(fromCsv[i].title, fromJson[i].title) << "CSV row " << i;
+        EXPECT_EQ(fromCsv[i].year, fromJson[i].year) << "CSV row " << i;
+    }
+    EXPECT_EQ(fromTsv[1].title, "Tab\there, \"quoted\"\nline");
+    EXPECT_EQ(fromTsv[2].author, "b0");
+    EXPECT_EQ(fromCsv[2].author, "_:b0"); // CSV keeps the blank node label as written
+
+    // Columns the struct does not declare are skipped; missing ones stay value-initialized
+    auto partial = SparqlReflector::parseDelimitedResponse<Person>("?unused\t?age\n\"x\"\t42\n", ResultFormat::Tsv);
+    ASSERT_EQ(partial.size(), 1);
+    EXPECT_EQ(partial[0].age, 42);
+    EXPECT_TRUE(partial[0].name.empty());
+}
+
+/**
+ * @brief Verify that failing pages are split and retried, then reported to the consumer.
+ */
+TEST(PagingTest, FailedPagesAreSplitThenReported) {
+    PagedQuery<Book>::Options options;
+    options.endpoint = "http://127.0.0.1:1/sparql"; // Nothing listens on port 1
+    options.pageSize = 100;
+    options.minPageSize = 25;
+    options.maxRetries = 3;
+    options.retryDelay = std::chrono::milliseconds(0);
+
+    auto books = PagedQuery<Book>::simple("{ ?book rdfs:label ?title. } ORDER BY ?book", options);
+    EXPECT_THROW((void)books.begin(), std::runtime_error);
+
+    // Two retries halved the page: 100 -> 50 -> 25
+    EXPECT_EQ(books.stats().retries, 2);
+    EXPECT_EQ(books.stats().pageSize, 25);
+    EXPECT_EQ(books.stats().rows, 0);
+}
+
+/**
+ * @brief Verify that per-thread metrics are aggregated (including exited threads) and exported.
+ */
+TEST(MetricsTest, AggregatesAcrossThreadsAndExports) {
+    if constexpr (!Metrics::kEnabled) GTEST_SKIP() << "Built with SPARQ_METRICS=0";
+    Metrics::reset();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 1000; ++i) {
+                Metrics::record(Metrics::Phase::MemberDecode, std::chrono::microseconds(5));
+                Metrics::add(Metrics::Counter::Rows);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // Recorded on this (still running) thread
+    auto people = SparqlReflector::parseJsonResponse<Person>(
+        R"({ "results": { "bindings": [ { "name": { "type": "literal", "value": "Ada" }, "age": { "type": "literal", "value": "n/a" } } ] } })");
+    ASSERT_EQ(people.size(), 1);
+
+    const Metrics::Snapshot totals = Metrics::snapshot();
+    EXPECT_EQ(totals[Metrics::Counter::Rows], 4001);
+    EXPECT_EQ(totals[Metrics::Counter::DecodeFailures], 1);
+    EXPECT_EQ(totals[Metrics::Phase::MemberDecode].count, 4001);
+    EXPECT_GE(totals[Metrics::Phase::MemberDecode].buckets[0], 4000); // 5us falls in the 10us bucket
+    EXPECT_EQ(totals[Metrics::Phase::BindingsExtraction].count, 1);
+
+    const std::string prometheus = Metrics::toPrometheus();
+    EXPECT_NE(prometheus.find("sparq_rows_total 4001"), std::string::npos);
+    EXPECT_NE(prometheus.find(R"(sparq_phase_seconds_count{phase="member_decode"} 4001)"), std::string::npos);
+    EXPECT_NE(prometheus.find(R"(sparq_phase_seconds_bucket{phase="member_decode",le="+Inf"} 4001)"), std::string::npos);
+
+    const std::string json = Metrics::toJson();
+    EXPECT_NE(json.find(R"("decode_failures":1)"), std::string::npos);
+
+    Metrics::reset();
+    EXPECT_EQ(Metrics::snapshot()[Metrics::Counter::Rows], 0);
+}
+
+/**
+ * @brief Compile-time templates must produce the same URL as building and encoding the
+ * query at runtime, and must reject values that would change the query's structure.
+ */
+TEST(QueryTemplateTest, BindsPlaceholdersIntoEncodedUrl) {
+    using Lookup = QueryTemplate<Person, R"({ wd:{id} rdfs:label ?name; ex:note {str}; ex:page {iri}. FILTER(LANG(?name) = "{lang}") } LIMIT {int})">;
+    static_assert(Lookup::kPlaceholderCount == 5);
+    static_assert(Lookup::text().starts_with("SELECT ?name ?age WHERE { wd:{id} rdfs:label"));
+    static_assert(SparqlReflector::selectClause<Book>() == "SELECT ?title ?author ?year");
+
+    Lookup lookup("https://example.org/sparql");
+    const std::string expected = SparqlReflector::buildQueryUrl("https://example.org/sparql",
+        R"(SELECT ?name ?age WHERE { wd:Q42 rdfs:label ?name; ex:note "say \"hi\"\n"; ex:page <http://example.org/a?b=1>. FILTER(LANG(?name) = "pt-BR") } LIMIT 25)");
+    EXPECT_EQ(lookup.url("Q42", "pt-BR", "say \"hi\"\n", "http://example.org/a?b=1", 25), expected);
+
+    // The buffer is reused; a second binding fully replaces the first
+    const std::string second = lookup.url(std::string("P31"), "en", "", "urn:x", -1);
+    EXPECT_NE(second.find("wd%3AP31"), std::string::npos);
+    EXPECT_NE(second.find("LIMIT%20-1"), std::string::npos);
+    EXPECT_EQ(second.find("Q42"), std::string::npos);
+
+    EXPECT_THROW(lookup.url("Q42 } DROP ALL #", "en", "", "urn:x", 1), std::invalid_argument);
+    EXPECT_THROW(lookup.url("Q42", "en\")", "", "urn:x", 1), std::invalid_argument);
+    EXPECT_THROW(lookup.url("Q42", "en", "", "http://x> } #", 1), std::invalid_argument);
+}
+
+/**
+ * @brief With an arena, the result vector and std::pmr::string members must be allocated
+ * from it and nothing may fall back to the default resource.
+ */
+TEST(ReflectionTest, ParseJsonResponseIntoArena) {
+    struct CountingResource : std::pmr::memory_resource {
+        size_t allocations = 0;
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    const std::string json = R"({ "results": { "bindings": [
+        { "name": { "type": "literal", "value": "A name well past the small string buffer" }, "age": { "value": "36" } },
+        { "name": { "type": "literal", "value": "Escaped \"quotes\" also land in the arena" } }
+    ] } })";
+
+    // Restores the default resource even if the parse throws
+    struct DefaultResourceGuard {
+        std::pmr::memory_resource* previous;
+        explicit DefaultResourceGuard(std::pmr::memory_resource* resource)
+            : previous(std::pmr::set_default_resource(resource)) {}
+        ~DefaultResourceGuard() { std::pmr::set_default_resource(previous); }
+    };
+
+    CountingResource fallback;
+    std::array<std::byte, 4096> storage;
+    std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(), std::pmr::null_memory_resource());
+    {
+        auto people = [&] {
+            DefaultResourceGuard guard(&fallback);
+            return SparqlReflector::parseJsonResponse<ArenaPerson>(json, &arena);
+        }();
+
+        ASSERT_EQ(people.size(), 2);
+        EXPECT_EQ(people[0].name, "A name well past the small string buffer");
+        EXPECT_EQ(people[0].age, 36);
+        EXPECT_EQ(people[1].name, "Escaped \"quotes\" also land in the arena");
+        EXPECT_EQ(people.get_allocator().resource(), &arena);
+        EXPECT_EQ(people[0].name.get_allocator().resource(), &arena);
+        EXPECT_EQ(people[1].name.get_allocator().resource(), &arena);
+    }
+    EXPECT_EQ(fallback.allocations, 0);
+}
+
+/**
+ * @brief Interned members must store one dictionary entry per distinct value, compare by id,
+ * and still read back (and print) as the original text, escapes included.
+ */
+TEST(ReflectionTest, InternedMembersShareDictionaryEntries) {
+    const std::string json = R"({ "results": { "bindings": [
+        { "langLabel": { "value": "C" }, "creatorLabel": { "value": "Dennis Ritchie" } },
+        { "langLabel": { "value": "B" }, "creatorLabel": { "value": "Ken Thompson" } },
+        { "langLabel": { "value": "Go" }, "creatorLabel": { "value": "Ken Thompson" } },
+        { "langLabel": { "value": "Q" }, "creatorLabel": { "value": "\"Ken\" Thompson" } },
+        { "langLabel": { "value": "X" } }
+    ] } })";
+
+    const size_t before = Interned<CreatorTag>::dictionarySize();
+    auto rows = SparqlReflector::parseJsonResponse<LanguageRow>(json);
+    ASSERT_EQ(rows.size(), 5);
+    EXPECT_EQ(Interned<CreatorTag>::dictionarySize(), before + 3);
+
+    EXPECT_EQ(rows[1].creatorLabel, rows[2].creatorLabel);
+    EXPECT_EQ(rows[1].creatorLabel.id(), rows[2].creatorLabel.id());
+    EXPECT_NE(rows[0].creatorLabel, rows[1].creatorLabel);
+    EXPECT_EQ(rows[0].creatorLabel, "Dennis Ritchie");
+    EXPECT_EQ(rows[3].creatorLabel.view(), "\"Ken\" Thompson");
+    EXPECT_TRUE(rows[4].creatorLabel.empty());
+    EXPECT_EQ(std::format("[{}]", rows[2].creatorLabel), "[Ken Thompson]");
+    EXPECT_EQ(Interned<CreatorTag>("Ken Thompson"), rows[1].creatorLabel);
+    EXPECT_EQ(Interned<>::dictionarySize(), 1) << "Tags must not share a dictionary";
+}
+
+/**
+ * @brief Grouped parsing must fold the cross product of two joins back into one parent per
+ * key, with each distinct child once, in first-seen order; unbound OPTIONAL children are skipped.
+ */
+TEST(ReflectionTest, ParseJsonResponseGrouped) {
+    auto binding = [](std::string_view lang, std::string_view year, std::string_view creator, std::string_view paradigm) {
+        std::string row = std::format(R"({{ "langLabel": {{ "value": "{}" }}, "year": {{ "value": "{}" }}, "creatorLabel": {{ "value": "{}" }})",
+                                      lang, year, creator);
+        if (!paradigm.empty()) row += std::format(R"(, "paradigmLabel": {{ "value": "{}" }})", paradigm);
+        return row + " }";
+    };
+    const std::string json = R"({ "results": { "bindings": [ )" +
+        binding("C", "1972", "Dennis Ritchie", "procedural") + "," +
+        binding("C", "1972", "Dennis Ritchie", "imperative") + "," +
+        binding("C", "1972", "Ken Thompson", "procedural") + "," +
+        binding("Go", "2009", "Rob Pike", "") + "," +
+        binding("C", "1972", "Ken Thompson", "imperative") + "," +
+        binding("Go", "2009", "Ken Thompson", "") + " ] } }";
+
+    auto languages = SparqlReflector::parseJsonResponseGrouped<LanguageGroup>(json);
+    ASSERT_EQ(languages.size(), 2);
+
+    EXPECT_EQ(languages[0].langLabel, "C");
+    EXPECT_EQ(languages[0].year, 1972);
+    ASSERT_EQ(languages[0].creators.size(), 2);
+    EXPECT_EQ(languages[0].creators[0].creatorLabel, "Dennis Ritchie");
+    EXPECT_EQ(languages[0].creators[1].creatorLabel, "Ken Thompson");
+    ASSERT_EQ(languages[0].paradigms.size(), 2);
+    EXPECT_EQ(languages[0].paradigms[0].paradigmLabel, "procedural");
+    EXPECT_EQ(languages[0].paradigms[1].paradigmLabel, "imperative");
+
+    EXPECT_EQ(languages[1].langLabel, "Go");
+    ASSERT_EQ(languages[1].creators.size(), 2);
+    EXPECT_EQ(languages[1].creators[1].creatorLabel, "Ken Thompson");
+    EXPECT_TRUE(languages[1].paradigms.empty());
+}
+
+/**
+ * @brief VALUES batching must cover every key exactly once within the URL budget, reject
+ * keys that would alter the query, and route rows back to the key (or keys) they belong to.
+ */
+TEST(BatchLookupTest, ChunksKeysAndRoutesRowsBack) {
+    BatchQueryExecutor executor(BatchQueryExecutor::Options{ .endpoint = "http://127.0.0.1:1/sparql" });
+    using Lookup = BatchLookup<Person, ^^Person::name>;
+    Lookup lookup(executor, "SELECT ?name ?age WHERE { {values} ?name ex:age ?age }",
+                  Lookup::Options{ .maxUrlLength = 600, .maxKeysPerChunk = 40 });
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 300; ++i) keys.push_back(std::format("Q{}", i));
+    keys.push_back("Q7"); // Duplicate
+
+    const std::vector<std::string> queries = lookup.chunkQueries(keys);
+    EXPECT_GT(queries.size(), 300u / 40);
+    size_t terms = 0;
+    for (const std::string& query : queries) {
+        EXPECT_TRUE(query.starts_with("SELECT ?name ?age WHERE { VALUES ?name { wd:Q"));
+        EXPECT_TRUE(query.ends_with(" } ?name ex:age ?age }"));
+        EXPECT_LE(SparqlReflector::buildQueryUrl(executor.endpoint(), query).size(), 600u);
+        for (size_t at = query.find("wd:"); at != std::string::npos; at = query.find("wd:", at + 1)) ++terms;
+    }
+    EXPECT_EQ(terms, 300u);
+
+    const std::vector<std::string> hostile = { "Q1", "Q2 } . ?s ?p ?o . VALUES ?x {" };
+    EXPECT_THROW(lookup.chunkQueries(hostile), std::invalid_argument);
+
+    const std::vector<std::string> wanted = { "Q42", "Q1", "Q42" };
+    std::vector<Person> rows = { { "http://www.wikidata.org/entity/Q42", 1 }, { "http://www.wikidata.org/entity/Q9", 2 },
+                                 { "http://www.wikidata.org/entity/Q42", 3 } };
+    auto perKey = Lookup::demultiplex(wanted, std::move(rows));
+    ASSERT_EQ(perKey.size(), 3);
+    ASSERT_EQ(perKey[0].size(), 2);
+    EXPECT_EQ(perKey[0][1].age, 3);
+    EXPECT_TRUE(perKey[1].empty());
+    EXPECT_EQ(perKey[2].size(), 2);
+}
+
+/**
+ * @brief Identical requests must share one transfer, higher lanes must be served first,
+ * transient failures retried, and backoff must stay within its jitter ceiling.
+ */
+TEST(SchedulerTest, CoalescesRetriesAndServesByPriority) {
+    using namespace std::chrono_literals;
+    using Priority = RequestScheduler::Priority;
+    EXPECT_THROW(RequestScheduler(RequestScheduler::Options{ .requestsPerSecond = 0.0 }), std::invalid_argument);
+
+    // No initial burst: nothing is sent before the first token (50 ms), so all three calls queue up
+    RequestScheduler scheduler(RequestScheduler::Options{
+        .maxInFlight = 1, .requestsPerSecond = 20.0, .burst = 0.0, .maxAttempts = 2, .baseBackoff = 1ms });
+
+    auto low = scheduler.fetch("http://127.0.0.1:1/sparql?query=low", Priority::Low);
+    auto normal = scheduler.fetch("http://127.0.0.1:1/sparql?query=high", Priority::Normal);
+    auto joined = scheduler.fetch("http://127.0.0.1:1/sparql?query=high", Priority::High);
+
+    EXPECT_EQ(low.get().code, CURLE_COULDNT_CONNECT);
+    EXPECT_EQ(normal.wait_for(0s), std::future_status::ready) << "The raised request must finish first";
+    EXPECT_EQ(&joined.get(), &normal.get());
+
+    const RequestScheduler::Stats stats = scheduler.stats();
+    EXPECT_EQ(stats.coalesced, 1);
+    EXPECT_EQ(stats.sent, 4);
+    EXPECT_EQ(stats.retries, 2);
+
+    std::mt19937_64 random(7);
+    const RequestScheduler::Options options{ .baseBackoff = 100ms, .maxBackoff = 1s };
+    for (size_t attempt = 1; attempt <= 8; ++attempt) {
+        const auto delay = RequestScheduler::backoff(options, attempt, random);
+        EXPECT_LE(delay, std::min<std::chrono::milliseconds>(1s, 100ms * (1 << (attempt - 1))));
+    }
+
+    NetworkClient::HttpResponse response;
+    response.status = 429;
+    EXPECT_TRUE(RequestScheduler::retryable(response));
+    response.status = 400;
+    EXPECT_FALSE(RequestScheduler::retryable(response));
+}
+
+/**
+ * @brief Re-running a query must report only the rows that were inserted, changed or
+ * removed, and an unchanged re-run must report nothing.
+ */
+TEST(SnapshotDiffTest, ReportsInsertedUpdatedAndDeletedRows) {
+    SnapshotDiff<Person, ^^Person::name> people;
+
+    auto first = people.apply({ {"Alice", 30}, {"Bob", 25}, {"Carol", 41} });
+    EXPECT_EQ(first.inserted.size(), 3);
+    EXPECT_TRUE(first.updated.empty() && first.deleted.empty());
+
+    auto second = people.apply({ {"Alice", 30}, {"Bob", 26}, {"Dave", 19} });
+    ASSERT_EQ(second.size(), 3);
+    ASSERT_EQ(second.inserted.size(), 1);
+    EXPECT_EQ(second.inserted[0].name, "Dave");
+    ASSERT_EQ(second.updated.size(), 1);
+    EXPECT_EQ(second.updated[0].age, 26);
+    ASSERT_EQ(second.deleted.size(), 1);
+    EXPECT_EQ(second.deleted[0].name, "Carol");
+
+    EXPECT_TRUE(people.apply(people.snapshot()).empty());
+
+    using Diff = SnapshotDiff<Person, ^^Person::name>;
+    EXPECT_EQ(Diff::keyHash({"Bob", 25}), Diff::keyHash({"Bob", 26}));
+    EXPECT_NE(Diff::rowHash({"Bob", 25}), Diff::rowHash({"Bob", 26}));
+    EXPECT_EQ(Diff::rowHash({"Bob", 25}), Diff::rowHash({"Bob", 25}));
+}
+
+/**
+ * @brief Rows must round-trip through the mmap'd snapshot for every supported member kind,
+ * be readable in place, and a file written for another layout must be rejected.
+ */
+TEST(BinarySnapshotTest, RoundTripsAndRejectsOtherLayouts) {
+    using namespace std::chrono;
+    const std::vector<Mission> missions = {
+        {"Apollo 11", true, MissionStatus::Retired, sys_seconds(seconds(-14182940)), 3, "AS-506", {'N', 'A', 'S', 'A'}, 355e6},
+        {"Voyager 1", false, MissionStatus::Active, sys_seconds(seconds(241056000)), std::nullopt, "VGR1", {'J', 'P', 'L', '\0'}, 865e6},
+    };
+    const auto path = std::filesystem::temp_directory_path() / "sparqreflect_snapshot_test.snap";
+    BinarySnapshot<Mission>::write(path, missions);
+
+    auto snapshot = BinarySnapshot<Mission>::open(path);
+    ASSERT_TRUE(snapshot.has_value());
+    ASSERT_EQ(snapshot->size(), 2);
+    EXPECT_EQ(snapshot->get<^^Mission::name>(1), "Voyager 1");
+    EXPECT_EQ(snapshot->get<^^Mission::crewSize>(0), 3);
+    EXPECT_FALSE(snapshot->get<^^Mission::crewSize>(1).has_value());
+    EXPECT_EQ(snapshot->column<^^Mission::budget>()[1], 865e6);
+
+    const std::vector<Mission> loaded = snapshot->toVector();
+    for (size_t i = 0; i < missions.size(); ++i) {
+        EXPECT_EQ(loaded[i].name, missions[i].name);
+        EXPECT_EQ(loaded[i].crewed, missions[i].crewed);
+        EXPECT_EQ(loaded[i].status, missions[i].status);
+        EXPECT_EQ(loaded[i].launch, missions[i].launch);
+        EXPECT_EQ(loaded[i].crewSize, missions[i].crewSize);
+        EXPECT_STREQ(loaded[i].code, missions[i].code);
+        EXPECT_EQ(loaded[i].agency, missions[i].agency);
+        EXPECT_EQ(loaded[i].budget, missions[i].budget);
+    }
+
+    EXPECT_FALSE(BinarySnapshot<Person>::open(path).has_value());
+    EXPECT_FALSE(BinarySnapshot<Mission>::open(path.string() + ".missing").has_value());
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief Local stand-in for a SPARQL endpoint: answers every request on 127.0.0.1 with an
+ * empty result after a fixed delay, one connection at a time.
+ */
+class StandInEndpoint {
+public:
+    explicit StandInEndpoint(std::chrono::milliseconds delay) : delay(delay) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), length);
+        ::listen(listener, 16);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        url = std::format("http://127.0.0.1:{}/sparql", ntohs(address.sin_port));
+        server = std::thread([this] { serve(); });
+    }
+
+    ~StandInEndpoint() {
+        ::shutdown(listener, SHUT_RDWR); // Unblocks accept()
+        server.join();
+        ::close(listener);
+    }
+
+    std::string url;
+
+private:
+    void serve() {
+        static constexpr std::string_view kBody = R"({"head":{"vars":["name"]},"results":{"bindings":[]}})";
+        for (int client; (client = ::accept(listener, nullptr, nullptr)) >= 0; ::close(client)) {
+            std::string request;
+            char buffer[4096];
+            for (ssize_t n; request.find("\r\n\r\n") == std::string::npos && (n = ::recv(client, buffer, sizeof(buffer), 0)) > 0;) {
+                request.append(buffer, static_cast<size_t>(n));
+            }
+            std::this_thread::sleep_for(delay);
+            const std::string response = std::format("HTTP/1.1 200 OK\r\nContent-Type: application/sparql-results+json\r\n"
+                                                     "Content-Length: {}\r\nConnection: close\r\n\r\n{}", kBody.size(), kBody);
+            ::send(client, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+    }
+
+    std::chrono::milliseconds delay;
+    int listener;
+    std::thread server;
+};
+
+/**
+ * @brief A slow endpoint must be hedged onto a fast one, a dead endpoint must fail over and
+ * leave rotation, and latency must be tracked per endpoint.
+ */
+TEST(RouterTest, HedgesSlowAndFailsOverFromDeadEndpoints) {
+    using namespace std::chrono_literals;
+    // Wide margins so a loaded machine cannot make the fast endpoint lose a hedge
+    StandInEndpoint slow(2000ms), fast(0ms);
+
+    EndpointRouter hedging({slow.url, fast.url}, EndpointRouter::Options{ .initialHedgeDelay = 300ms });
+    for (int i = 0; i < 4; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        EXPECT_TRUE(hedging.fetch("SELECT ?name WHERE {}").ok());
+        EXPECT_LT(std::chrono::steady_clock::now() - start, 1500ms) << "The fast endpoint must answer first";
+    }
+    EXPECT_EQ(hedging.endpointStats()[0].successes, 0) << "The slow endpoint never produces the winning response";
+    EXPECT_EQ(hedging.endpointStats()[1].successes, 4);
+
+    EndpointRouter failover({"http://127.0.0.1:1/sparql", fast.url},
+                            EndpointRouter::Options{ .hedge = false, .failureThreshold = 1, .cooldown = 60s });
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(failover.fetch("SELECT ?name WHERE {}").ok());
+    }
+    const auto endpoints = failover.endpointStats();
+    EXPECT_EQ(endpoints[0].failures, 1) << "After one failure the dead endpoint leaves rotation";
+    EXPECT_FALSE(endpoints[0].healthy);
+    EXPECT_EQ(endpoints[1].successes, 4);
+    EXPECT_GT(endpoints[1].latencyMs, 0.0);
+    EXPECT_EQ(failover.stats().failovers, 1);
+}
+
+/**
+ * @brief Every export format must escape text, render optionals, enums and time points, and the
+ * binary format must length-prefix rows, including values written by reference.
+ */
+TEST(ExportTest, WritesNdjsonCsvAndLengthPrefixedBinary) {
+    using namespace std::chrono;
+    const std::vector<Mission> missions = {
+        {"Apollo \"11\", crewed", true, MissionStatus::Retired, sys_seconds(seconds(0)), 3, "AS-506", {'N', 'A', 'S', 'A'}, 1.5},
+        {"Voyager\n1", false, MissionStatus::Active, sys_seconds(seconds(86400)), std::nullopt, "VGR1", {'J', 'P', 'L', '\0'}, 2.25},
+    };
+    const auto path = std::filesystem::temp_directory_path() / "sparqreflect_export_test";
+    auto contents = [&] {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    };
+
+    BulkExporter::writeFile<Mission>(path, missions, ExportFormat::Ndjson);
+    EXPECT_EQ(contents(),
+              "{\"name\":\"Apollo \\\"11\\\", crewed\",\"crewed\":true,\"status\":\"Retired\",\"launch\":\"1970-01-01T00:00:00Z\","
+              "\"crewSize\":3,\"code\":\"AS-506\",\"agency\":\"NASA\",\"budget\":1.5}\n"
+              "{\"name\":\"Voyager\\n1\",\"crewed\":false,\"status\":\"Active\",\"launch\":\"1970-01-02T00:00:00Z\","
+              "\"crewSize\":null,\"code\":\"VGR1\",\"agency\":\"JPL\",\"budget\":2.25}\n");
+
+    BulkExporter::writeFile<Mission>(path, missions, ExportFormat::Csv);
+    EXPECT_EQ(contents(),
+              "name,crewed,status,launch,crewSize,code,agency,budget\n"
+              "\"Apollo \"\"11\"\", crewed\",true,Retired,1970-01-01T00:00:00Z,3,AS-506,NASA,1.5\n"
+              "\"Voyager\n1\",false,Active,1970-01-02T00:00:00Z,,VGR1,JPL,2.25\n");
+
+    BulkExporter::writeFile<Mission>(path, missions, ExportFormat::Binary);
+    std::string binary = contents();
+    ASSERT_EQ(binary.size(), 16 + 4 + 67 + 4 + 50);
+    EXPECT_EQ(binary.substr(0, 8), "SPQROWS1");
+    std::uint64_t fingerprint = 0;
+    std::uint32_t firstRow = 0;
+    std::memcpy(&fingerprint, binary.data() + 8, sizeof(fingerprint));
+    std::memcpy(&firstRow, binary.data() + 16, sizeof(firstRow));
+    EXPECT_EQ(fingerprint, SparqlReflector::layoutFingerprint<Mission>());
+    EXPECT_EQ(firstRow, 67);
+
+    // Long text goes out by reference in the same writev as the buffered bytes around it
+    const std::vector<Person> people = { {std::string(5000, 'x'), 7} };
+    {
+        OutputSink sink(path, 64);
+        BulkExporter::writeBinary<Person>(sink, people);
+        EXPECT_EQ(sink.referencedBytes(), 5000);
+        EXPECT_EQ(sink.bytesWritten(), 16 + 4 + 4 + 5000 + 4);
+    }
+    binary = contents();
+    ASSERT_EQ(binary.size(), 16 + 4 + 4 + 5000 + 4);
+    EXPECT_EQ(binary.substr(24, 5000), people[0].name);
+    std::filesystem::remove(path);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,148 @@
+// End-to-end load driver: URL building, transfer, parsing and decoding under concurrency.
+//
+//   load_driver --endpoint http://127.0.0.1:8089/sparql --concurrency 16 --requests 20000 --format tsv
+//
+// Every worker thread issues the query back to back through NetworkClient and decodes the
+// response into MockRow (the variables served by tools/mock_sparql_server). Reports
+// queries/s, rows/s, error counts and the p50/p90/p99/max of the end-to-end latency.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <map>
+#include <mutex>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "NetworkClient.hpp"
+#include "SPARQReflector.hpp"
+
+struct MockRow {
+    std::string label;
+    long long value;
+};
+
+struct DriverOptions {
+    std::string endpoint = "http://127.0.0.1:8089/sparql";
+    std::string query = "SELECT ?label ?value WHERE { ?item rdfs:label ?label; ex:value ?value } LIMIT 1000";
+    ResultFormat format = ResultFormat::Json;
+    size_t concurrency = 8;
+    /// Total requests; ignored when duration is set.
+    size_t requests = 1000;
+    std::chrono::seconds duration{0};
+    bool printMetrics = false;
+};
+
+/**
+ * @brief Results of one worker, merged after the run.
+ */
+struct WorkerResult {
+    std::vector<std::chrono::nanoseconds> latencies;
+    size_t rows = 0;
+    std::map<std::string, size_t> failures; ///< "curl: ..." or "HTTP nnn" -> count
+};
+
+static std::chrono::nanoseconds percentile(const std::vector<std::chrono::nanoseconds>& sorted, double p) {
+    if (sorted.empty()) return {};
+    const auto rank = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+static double millis(std::chrono::nanoseconds value) {
+    return std::chrono::duration<double, std::milli>(value).count();
+}
+
+static void run(const DriverOptions& options) {
+    const std::string url = SparqlReflector::buildQueryUrl(options.endpoint, options.query);
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + options.duration;
+    std::atomic<size_t> issued{0};
+
+    std::vector<WorkerResult> results(options.concurrency);
+    std::vector<std::jthread> workers;
+    for (size_t w = 0; w < options.concurrency; ++w) {
+        workers.emplace_back([&, w] {
+            WorkerResult& result = results[w];
+            NetworkClient client;
+            while (options.duration.count() > 0 ? std::chrono::steady_clock::now() < deadline
+                                                : issued.fetch_add(1, std::memory_order_relaxed) < options.requests) {
+                const auto sent = std::chrono::steady_clock::now();
+                NetworkClient::HttpResponse response = client.fetch(url, options.format);
+                if (response.ok()) {
+                    result.rows += SparqlReflector::parseResponse<MockRow>(response.body, options.format).size();
+                    result.latencies.push_back(std::chrono::steady_clock::now() - sent);
+                } else if (response.code != CURLE_OK) {
+                    ++result.failures[std::format("curl: {}", curl_easy_strerror(response.code))];
+                } else {
+                    ++result.failures[std::format("HTTP {}", response.status)];
+                }
+            }
+        });
+    }
+    workers.clear(); // Joins
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::chrono::nanoseconds> latencies;
+    std::map<std::string, size_t> failures;
+    size_t rows = 0, failed = 0;
+    for (WorkerResult& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        rows += result.rows;
+        for (const auto& [reason, count] : result.failures) {
+            failures[reason] += count;
+            failed += count;
+        }
+    }
+    std::ranges::sort(latencies);
+
+    std::println("requests:    {} ok, {} failed in {:.2f} s (concurrency {})", latencies.size(), failed, elapsed.count(), options.concurrency);
+    std::println("throughput:  {:.1f} queries/s, {:.0f} rows/s", static_cast<double>(latencies.size()) / elapsed.count(),
+                 static_cast<double>(rows) / elapsed.count());
+    std::println("latency ms:  p50 {:.2f}  p90 {:.2f}  p99 {:.2f}  max {:.2f}", millis(percentile(latencies, 0.50)),
+                 millis(percentile(latencies, 0.90)), millis(percentile(latencies, 0.99)),
+                 millis(latencies.empty() ? std::chrono::nanoseconds{} : latencies.back()));
+    for (const auto& [reason, count] : failures) std::println("  {:>6} x {}", count, reason);
+    if (options.printMetrics) std::println("\n{}", Metrics::toPrometheus());
+}
+
+static void printUsage() {
+    std::println("usage: load_driver [--endpoint URL] [--query SPARQL] [--format json|tsv|csv] [--concurrency N]\n"
+                 "                   [--requests N | --duration SECONDS] [--metrics]");
+}
+
+int main(int argc, char** argv) {
+    DriverOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto next = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                printUsage();
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        auto number = [&] { return std::strtoull(std::string(next()).c_str(), nullptr, 10); };
+
+        if (arg == "--endpoint") options.endpoint = next();
+        else if (arg == "--query") options.query = next();
+        else if (arg == "--concurrency") options.concurrency = std::max<size_t>(number(), 1);
+        else if (arg == "--requests") options.requests = number();
+        else if (arg == "--duration") options.duration = std::chrono::seconds(number());
+        else if (arg == "--metrics") options.printMetrics = true;
+        else if (arg == "--format") {
+            const std::string_view format = next();
+            options.format = format == "tsv" ? ResultFormat::Tsv : format == "csv" ? ResultFormat::Csv : ResultFormat::Json;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    run(options);
+    return 0;
+}
@@ -0,0 +1,344 @@
+// Local SPARQL endpoint for offline, reproducible end-to-end runs.
+//
+//   mock_sparql_server --port 8089 --rows 5000 --latency-ms 20 --jitter-ms 10 \
+//                      --bandwidth 2000000 --chunked --gzip --error-rate 0.02 --error-status 429
+//
+// Serves GET /sparql?query=... over HTTP/1.1 keep-alive. The body is either a recorded
+// response (--file) or a synthetic result with the variables ?label and ?value in the
+// format asked for by the Accept header (JSON, TSV or CSV). Synthetic results honour the
+// query's LIMIT and OFFSET, so paged clients see a finite result of --rows rows.
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <print>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if SPARQ_MOCK_ZLIB
+#include <zlib.h>
+#endif
+
+struct ServerOptions {
+    uint16_t port = 8089;
+    /// Recorded response served for every query; synthetic results when empty.
+    std::string responseFile;
+    /// Rows in the synthetic result, before LIMIT/OFFSET.
+    size_t rows = 1000;
+    std::chrono::milliseconds latency{0};
+    /// Uniform extra delay in [0, jitter] added to every response.
+    std::chrono::milliseconds jitter{0};
+    /// Bytes per second per connection; 0 means unlimited.
+    size_t bandwidth = 0;
+    bool chunked = false;
+    size_t chunkSize = 16 * 1024;
+    /// Compress with gzip when the client accepts it (requires zlib at build time).
+    bool gzip = false;
+    /// Fraction of requests answered with errorStatus instead of the result.
+    double errorRate = 0.0;
+    int errorStatus = 503;
+    /// Retry-After seconds sent with injected 429s.
+    int retryAfter = 1;
+};
+
+/**
+ * @brief One parsed request: the decoded query and the headers the server reacts to.
+ */
+struct Request {
+    std::string query;
+    std::string accept;
+    bool acceptsGzip = false;
+    bool keepAlive = true;
+};
+
+class MockSparqlServer {
+public:
+    explicit MockSparqlServer(ServerOptions opts) : options(std::move(opts)) {
+        if (!options.responseFile.empty()) {
+            std::ifstream in(options.responseFile, std::ios::binary);
+            if (!in) throw std::runtime_error(std::format("cannot read {}", options.responseFile));
+            recorded.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+#if !SPARQ_MOCK_ZLIB
+        if (options.gzip) std::println(stderr, "warning: built without zlib, --gzip is ignored");
+        options.gzip = false;
+#endif
+    }
+
+    /// Accepts connections until the process is stopped; one thread per connection.
+    void run() {
+        const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        const int yes = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(options.port);
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, 512) != 0) {
+            throw std::runtime_error(std::format("cannot listen on 127.0.0.1:{}", options.port));
+        }
+        std::println("Mock SPARQL endpoint: http://127.0.0.1:{}/sparql", options.port);
+
+        while (true) {
+            const int client = ::accept(listener, nullptr, nullptr);
+            if (client < 0) continue;
+            ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            std::thread([this, client] { serve(client); }).detach();
+        }
+    }
+
+private:
+    void serve(int client) {
+        std::mt19937_64 random(std::random_device{}());
+        std::string pending;
+        Request request;
+        while (readRequest(client, pending, request)) {
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+            auto delay = options.latency;
+            if (options.jitter.count() > 0) {
+                delay += std::chrono::milliseconds(static_cast<int64_t>(unit(random) * static_cast<double>(options.jitter.count())));
+            }
+            if (delay.count() > 0) std::this_thread::sleep_for(delay);
+
+            const bool sent = unit(random) < options.errorRate ? sendError(client, request)
+                                                                : sendResult(client, request);
+            if (!sent || !request.keepAlive) break;
+        }
+        ::close(client);
+    }
+
+    // Reads one request head (GET only, bodies are not expected); leftover bytes stay in pending
+    static bool readRequest(int client, std::string& pending, Request& request) {
+        size_t headEnd;
+        while ((headEnd = pending.find("\r\n\r\n")) == std::string::npos) {
+            char buffer[8192];
+            const ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+            if (received <= 0 || pending.size() > (1u << 20)) return false;
+            pending.append(buffer, static_cast<size_t>(received));
+        }
+        const std::string head = pending.substr(0, headEnd);
+        pending.erase(0, headEnd + 4);
+
+        request = Request{};
+        const size_t lineEnd = head.find("\r\n");
+        const std::string_view requestLine = std::string_view(head).substr(0, lineEnd);
+        if (const size_t q = requestLine.find("query="); q != std::string_view::npos) {
+            std::string_view raw = requestLine.substr(q + 6);
+            raw = raw.substr(0, std::min(raw.find('&'), raw.find(' ')));
+            request.query = percentDecode(raw);
+        }
+        request.keepAlive = !requestLine.ends_with("HTTP/1.0");
+
+        std::istringstream headers(head.substr(std::min(lineEnd + 2, head.size())));
+        for (std::string line; std::getline(headers, line);) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            const size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            const std::string name = lowercase(line.substr(0, colon));
+            const std::string value = line.substr(std::min(line.find_first_not_of(' ', colon + 1), line.size()));
+            if (name == "accept") request.accept = value;
+            else if (name == "accept-encoding") request.acceptsGzip = lowercase(value).contains("gzip");
+            else if (name == "connection") request.keepAlive = lowercase(value) != "close";
+        }
+        return true;
+    }
+
+    bool sendError(int client, const Request& request) {
+        std::string head = std::format("HTTP/1.1 {} Injected\r\nContent-Type: text/plain\r\nContent-Length: 15\r\n", options.errorStatus);
+        if (options.errorStatus == 429) head += std::format("Retry-After: {}\r\n", options.retryAfter);
+        head += request.keepAlive ? "\r\n" : "Connection: close\r\n\r\n";
+        return sendPaced(client, head + "injected error\n");
+    }
+
+    bool sendResult(int client, const Request& request) {
+        std::string_view contentType = "application/sparql-results+json";
+        std::string body;
+        if (!recorded.empty()) {
+            body = recorded;
+            if (options.responseFile.ends_with(".tsv")) contentType = "text/tab-separated-values";
+            else if (options.responseFile.ends_with(".csv")) contentType = "text/csv";
+        } else {
+            if (request.accept.contains("tab-separated")) contentType = "text/tab-separated-values";
+            else if (request.accept.contains("csv")) contentType = "text/csv";
+            body = synthesize(request.query, contentType);
+        }
+
+        const bool gzip = options.gzip && request.acceptsGzip;
+        if (gzip) body = compress(body);
+
+        std::string head = std::format("HTTP/1.1 200 OK\r\nContent-Type: {}\r\n", contentType);
+        if (gzip) head += "Content-Encoding: gzip\r\n";
+        head += options.chunked ? "Transfer-Encoding: chunked\r\n" : std::format("Content-Length: {}\r\n", body.size());
+        head += request.keepAlive ? "\r\n" : "Connection: close\r\n\r\n";
+
+        if (!options.chunked) return sendPaced(client, head + body);
+
+        if (!sendPaced(client, head)) return false;
+        for (size_t offset = 0; offset < body.size(); offset += options.chunkSize) {
+            const std::string_view piece = std::string_view(body).substr(offset, options.chunkSize);
+            if (!sendPaced(client, std::format("{:x}\r\n{}\r\n", piece.size(), piece))) return false;
+        }
+        return sendPaced(client, "0\r\n\r\n");
+    }
+
+    // Rows [OFFSET, OFFSET + LIMIT) of the synthetic result
+    std::string synthesize(const std::string& query, std::string_view contentType) const {
+        const size_t offset = std::min(keywordValue(query, "offset", 0), options.rows);
+        const size_t count = std::min(keywordValue(query, "limit", options.rows), options.rows - offset);
+
+        std::string out;
+        auto it = std::back_inserter(out);
+        if (contentType == "text/tab-separated-values") {
+            out += "?label\t?value\n";
+            for (size_t i = offset; i < offset + count; ++i) std::format_to(it, "\"Label {}\"@en\t{}\n", i, i);
+        } else if (contentType == "text/csv") {
+            out += "label,value\r\n";
+            for (size_t i = offset; i < offset + count; ++i) std::format_to(it, "Label {},{}\r\n", i, i);
+        } else {
+            out += R"({ "head": { "vars": [ "label", "value" ] }, "results": { "bindings": [)";
+            for (size_t i = offset; i < offset + count; ++i) {
+                std::format_to(it, R"({}
+{{ "label": {{ "type": "literal", "xml:lang": "en", "value": "Label {}" }}, )"
+                                   R"("value": {{ "type": "literal", "datatype": "http://www.w3.org/2001/XMLSchema#integer", "value": "{}" }} }})",
+                               i > offset ? "," : "", i, i);
+            }
+            out += "\n] } }\n";
+        }
+        return out;
+    }
+
+    // Writes everything, holding the connection to options.bandwidth bytes per second
+    bool sendPaced(int client, std::string_view data) const {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t slice = options.bandwidth ? std::max<size_t>(options.bandwidth / 50, 512) : data.size();
+        size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t written = ::send(client, data.data() + sent, std::min(slice, data.size() - sent), MSG_NOSIGNAL);
+            if (written <= 0) return false;
+            sent += static_cast<size_t>(written);
+            if (options.bandwidth) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(sent * 1'000'000 / options.bandwidth));
+            }
+        }
+        return true;
+    }
+
+    static std::string compress([[maybe_unused]] const std::string& body) {
+#if SPARQ_MOCK_ZLIB
+        z_stream stream{};
+        deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY); // +16: gzip wrapper
+        std::string out(deflateBound(&stream, body.size()), '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+        stream.avail_in = static_cast<uInt>(body.size());
+        stream.next_out = reinterpret_cast<Bytef*>(out.data());
+        stream.avail_out = static_cast<uInt>(out.size());
+        deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return out;
+#else
+        return body;
+#endif
+    }
+
+    static std::string percentDecode(std::string_view raw) {
+        std::string out;
+        out.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] == '%' && i + 2 < raw.size()) {
+                unsigned value = 0;
+                if (std::from_chars(raw.data() + i + 1, raw.data() + i + 3, value, 16).ptr == raw.data() + i + 3) {
+                    out += static_cast<char>(value);
+                    i += 2;
+                    continue;
+                }
+            }
+            out += raw[i] == '+' ? ' ' : raw[i];
+        }
+        return out;
+    }
+
+    static std::string lowercase(std::string text) {
+        std::ranges::transform(text, text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    // Number after the last occurrence of keyword (case-insensitive), or fallback
+    static size_t keywordValue(const std::string& query, std::string_view keyword, size_t fallback) {
+        const std::string lower = lowercase(query);
+        const size_t at = lower.rfind(keyword);
+        if (at == std::string::npos) return fallback;
+        const size_t digits = lower.find_first_not_of(" \t\r\n", at + keyword.size());
+        size_t value = fallback;
+        if (digits != std::string::npos) std::from_chars(lower.data() + digits, lower.data() + lower.size(), value);
+        return value;
+    }
+
+    ServerOptions options;
+    std::string recorded;
+};
+
+static void printUsage() {
+    std::println("usage: mock_sparql_server [--port N] [--file PATH | --rows N] [--latency-ms N] [--jitter-ms N]\n"
+                 "                          [--bandwidth BYTES_PER_S] [--chunked] [--chunk-size N] [--gzip]\n"
+                 "                          [--error-rate FRACTION] [--error-status CODE] [--retry-after S]");
+}
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto next = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                printUsage();
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        auto number = [&] { return std::strtoull(std::string(next()).c_str(), nullptr, 10); };
+
+        if (arg == "--port") options.port = static_cast<uint16_t>(number());
+        else if (arg == "--file") options.responseFile = next();
+        else if (arg == "--rows") options.rows = number();
+        else if (arg == "--latency-ms") options.latency = std::chrono::milliseconds(number());
+        else if (arg == "--jitter-ms") options.jitter = std::chrono::milliseconds(number());
+        else if (arg == "--bandwidth") options.bandwidth = number();
+        else if (arg == "--chunked") options.chunked = true;
+        else if (arg == "--chunk-size") options.chunkSize = std::max<size_t>(number(), 1);
+        else if (arg == "--gzip") options.gzip = true;
+        else if (arg == "--error-rate") options.errorRate = std::strtod(std::string(next()).c_str(), nullptr);
+        else if (arg == "--error-status") options.errorStatus = static_cast<int>(number());
+        else if (arg == "--retry-after") options.retryAfter = static_cast<int>(number());
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    try {
+        MockSparqlServer(std::move(options)).run();
+    } catch (const std::exception& e) {
+        std::println(stderr, "error: {}", e.what());
+        return 1;
+    }
+}